@@ -0,0 +1,280 @@
+#include <hypara.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+using namespace std::chrono_literals;
+
+namespace
+{
+struct Options
+{
+    bool quick = false;
+    std::string strategy;
+    std::string output;
+    std::vector<size_t> threads;
+};
+
+struct Case
+{
+    std::string strategy;
+    size_t tasks;
+    std::chrono::microseconds work;
+    size_t threads;
+};
+
+struct Report
+{
+    Case config;
+    size_t iterations;
+    double p50;
+    double p99;
+    double p999;
+    double mean;
+    double calls_per_sec;
+    double tasks_per_sec;
+};
+
+// Busy-waits instead of sleeping, so short task durations are not rounded up by the scheduler
+int spin(int x, std::chrono::microseconds work)
+{
+    const auto until = Clock::now() + work;
+    while (Clock::now() < until)
+    {
+    }
+    return x;
+}
+
+double percentile(const std::vector<double>& sorted, double p)
+{
+    const auto index = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+/**
+ * \brief Times one call per iteration until the time budget is spent
+ */
+template<typename Call>
+Report measure(const Case& config, Clock::duration budget, Call&& call)
+{
+    // Warm up the pool and any lazily allocated state
+    for (int i = 0; i < 3; ++i)
+    {
+        call(i);
+    }
+
+    std::vector<double> samples;
+    const auto start = Clock::now();
+    int i = 0;
+    while (samples.size() < 10 || (Clock::now() - start < budget && samples.size() < 100000))
+    {
+        const auto begin = Clock::now();
+        call(i++);
+        samples.push_back(std::chrono::duration<double, std::micro>(Clock::now() - begin).count());
+    }
+    const double total = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::sort(samples.begin(), samples.end());
+    double sum = 0;
+    for (double sample : samples)
+    {
+        sum += sample;
+    }
+
+    const double calls = static_cast<double>(samples.size());
+    return Report{config,
+                  samples.size(),
+                  percentile(samples, 0.5),
+                  percentile(samples, 0.99),
+                  percentile(samples, 0.999),
+                  sum / calls,
+                  calls / total,
+                  calls * static_cast<double>(config.tasks) / total};
+}
+
+Report run_case(const Case& config, Clock::duration budget)
+{
+    hyp::ThreadPool pool(config.threads);
+    const auto work = config.work;
+
+    if (config.strategy == "task_spawn")
+    {
+        // Same as task_run on hypara's own future instead of std::promise and std::shared_future
+        hyp::Task<int(int)> task([work](int x) { return spin(x, work); }, pool);
+        std::vector<hyp::aux::Future<int>> futures(config.tasks);
+        return measure(config,
+                       budget,
+                       [&](int x)
+                       {
+                           for (auto& fut : futures)
+                           {
+                               fut = task.spawn(hyp::StopToken(), x);
+                           }
+                           for (auto& fut : futures)
+                           {
+                               fut.wait();
+                           }
+                       });
+    }
+
+    if (config.strategy == "task_run" || config.strategy == "task_then")
+    {
+        hyp::Task<int(int)> task([work](int x) { return spin(x, work); }, pool);
+        auto chained = task.then([](int x) { return x + 1; });
+        std::vector<std::shared_future<int>> futures(config.tasks);
+        return measure(config,
+                       budget,
+                       [&](int x)
+                       {
+                           for (auto& fut : futures)
+                           {
+                               fut = config.strategy == "task_run" ? task.run(x) : chained.run(x);
+                           }
+                           for (auto& fut : futures)
+                           {
+                               fut.wait();
+                           }
+                       });
+    }
+
+    hyp::Worker<int, int> worker(pool);
+    for (size_t i = 0; i < config.tasks; ++i)
+    {
+        worker.add_function("fn" + std::to_string(i), [work](int x) { return spin(x, work); });
+    }
+
+    const auto accept = [](const int& x) { return x >= 0; };
+    const auto less = [](const int& a, const int& b) { return a < b; };
+    if (config.strategy == "execute_any")
+    {
+        return measure(config, budget, [&](int x) { worker.execute_any(x); });
+    }
+    if (config.strategy == "execute_any_with")
+    {
+        return measure(config, budget, [&](int x) { worker.execute_any_with(accept, x); });
+    }
+    if (config.strategy == "execute_all")
+    {
+        return measure(config, budget, [&](int x) { worker.execute_all(x); });
+    }
+    if (config.strategy == "execute_best")
+    {
+        return measure(config, budget, [&](int x) { worker.execute_best(less, x); });
+    }
+    return measure(config, budget, [&](int x) { worker.execute_order_with(accept, x); });
+}
+
+void write_json(std::ostream& out, const std::vector<Report>& reports)
+{
+    out << "{\n  \"library\": \"hypara\",\n  \"hardware_concurrency\": " << std::thread::hardware_concurrency()
+        << ",\n  \"unit\": \"us\",\n  \"results\": [";
+    for (size_t i = 0; i < reports.size(); ++i)
+    {
+        const auto& r = reports[i];
+        out << (i ? ",\n" : "\n") << "    {\"strategy\": \"" << r.config.strategy << "\", \"tasks\": " << r.config.tasks
+            << ", \"task_duration_us\": " << r.config.work.count() << ", \"threads\": " << r.config.threads
+            << ", \"iterations\": " << r.iterations << ", \"p50\": " << r.p50 << ", \"p99\": " << r.p99
+            << ", \"p999\": " << r.p999 << ", \"mean\": " << r.mean << ", \"calls_per_sec\": " << r.calls_per_sec
+            << ", \"tasks_per_sec\": " << r.tasks_per_sec << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+Options parse(int argc, char** argv)
+{
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--quick")
+        {
+            options.quick = true;
+        }
+        else if (arg == "--strategy" && i + 1 < argc)
+        {
+            options.strategy = argv[++i];
+        }
+        else if (arg == "--output" && i + 1 < argc)
+        {
+            options.output = argv[++i];
+        }
+        else if (arg == "--threads" && i + 1 < argc)
+        {
+            options.threads.push_back(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else
+        {
+            std::cerr << "usage: hypara-bench [--quick] [--strategy name] [--threads n]... [--output file]\n";
+            std::exit(arg == "--help" ? 0 : 1);
+        }
+    }
+    return options;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const auto options = parse(argc, argv);
+
+    const std::vector<std::string> strategies = {"execute_any",
+                                                 "execute_any_with",
+                                                 "execute_all",
+                                                 "execute_best",
+                                                 "execute_order_with",
+                                                 "task_run",
+                                                 "task_spawn",
+                                                 "task_then"};
+    const std::vector<size_t> counts = options.quick ? std::vector<size_t>{1, 10, 100}
+                                                     : std::vector<size_t>{1, 10, 100, 1000, 10000};
+    const std::vector<std::chrono::microseconds> durations = {0us, 10us, 100us};
+    auto threads = options.threads;
+    if (threads.empty())
+    {
+        threads = {1, 4, hyp::ThreadPool::default_concurrency()};
+    }
+    const Clock::duration budget = options.quick ? Clock::duration(50ms) : Clock::duration(300ms);
+
+    std::vector<Report> reports;
+    for (const auto& strategy : strategies)
+    {
+        if (!options.strategy.empty() && strategy != options.strategy)
+        {
+            continue;
+        }
+        for (size_t count : counts)
+        {
+            for (auto work : durations)
+            {
+                // Keep every call under ~100ms of total work
+                if (work * static_cast<long>(count) > 100ms)
+                {
+                    continue;
+                }
+                for (size_t n : threads)
+                {
+                    reports.push_back(run_case({strategy, count, work, n}, budget));
+                    const auto& r = reports.back();
+                    std::cerr << strategy << " tasks=" << count << " work=" << work.count() << "us threads=" << n
+                              << " p50=" << r.p50 << "us p99=" << r.p99 << "us\n";
+                }
+            }
+        }
+    }
+
+    if (options.output.empty())
+    {
+        write_json(std::cout, reports);
+    }
+    else
+    {
+        std::ofstream file(options.output);
+        write_json(file, reports);
+    }
+    return 0;
+}
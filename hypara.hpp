@@ -1,851 +1,6841 @@
-#pragma once
-
-#ifndef _HYPARA_HPP_
-#define _HYPARA_HPP_
-
-#include <algorithm>
-#include <atomic>
-#include <chrono>
-#include <condition_variable>
-#include <functional>
-#include <future>
-#include <iostream>
-#include <memory>
-#include <optional>
-#include <queue>
-#include <string>
-#include <thread>
-#include <tuple>
-#include <type_traits>
-#include <utility>
-#include <vector>
-
-namespace hyp
-{
-/**
- * \brief Represents an asynchronous task that can be executed with specified arguments.
- * 
- * \tparam T Function signature type (e.g., int(double, float))
- */
-template<typename T>
-class Task;
-
-/**
- * \brief Specialization of Task for function signatures.
- * 
- * \tparam Ret Return type of the task
- * \tparam Args Argument types that the task accepts
- */
-template<typename Ret, typename... Args>
-class Task<Ret(Args...)>
-{
-public:
-    using return_type = Ret;
-    using function_type = std::function<Ret(Args...)>;
-
-    /**
-     * \brief Constructs a Task from a callable object
-     * 
-     * \tparam Fn Type of the callable object
-     * \param fn Callable object to be wrapped
-     */
-    template<typename Fn, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Fn>, Task>>>
-    explicit Task(Fn&& fn) : m_fn(std::forward<Fn>(fn))
-    {
-    }
-
-    /**
-     * \brief Executes the task asynchronously
-     * 
-     * \param args Arguments to pass to the task
-     * \return std::shared_future<Ret> Shared future representing the task result
-     */
-    std::shared_future<Ret> run(Args... args) const
-    {
-        auto task = std::make_shared<std::packaged_task<Ret(Args...)>>(m_fn);
-        auto fut = task->get_future().share();
-
-        std::thread(
-            [task, args...]() mutable
-            {
-                try
-                {
-                    (*task)(std::forward<Args>(args)...);
-                }
-                catch (...)
-                {
-                } // Suppress exceptions
-            })
-            .detach();
-
-        return fut;
-    }
-
-    /**
-     * \brief Blocks until the task completes
-     * 
-     * \param args Arguments to pass to the task
-     */
-    void wait(Args... args) const
-    {
-        run(std::forward<Args>(args)...).wait();
-    }
-
-    /**
-     * \brief Executes the task and returns the result
-     * 
-     * \param args Arguments to pass to the task
-     * \return Ret Result of the task
-     */
-    Ret get(Args... args) const
-    {
-        return run(std::forward<Args>(args)...).get();
-    }
-
-    /**
-     * \brief Chains another task to be executed after this one
-     * 
-     * \tparam Func Type of the continuation function
-     * \param fn Continuation function
-     * \return Task<NewRet(Args...)> New task representing the continuation
-     */
-    template<typename Func>
-    auto then(Func&& fn) const -> Task<typename std::invoke_result_t<Func, Ret>(Args...)>
-    {
-        using result_type = typename std::invoke_result_t<Func, Ret>;
-        return Task<result_type(Args...)>(
-            [func = m_fn, fn = std::forward<Func>(fn)](Args... args) mutable
-            {
-                auto fut = std::async(std::launch::async, func, std::forward<Args>(args)...);
-                return fn(fut.get());
-            });
-    }
-
-private:
-    function_type m_fn;
-};
-
-namespace aux
-{
-/**
- * \brief Type trait to extract the result type from futures
- * 
- * \tparam T Type to extract result from
- */
-template<typename T>
-struct range_trait
-{
-    using type = T;
-};
-
-/**
- * \brief Specialization for std::shared_future
- * 
- * \tparam Ret Result type of the future
- */
-template<typename Ret>
-struct range_trait<std::shared_future<Ret>>
-{
-    using type = Ret;
-};
-
-template<typename T>
-using range_trait_t = typename range_trait<T>::type;
-
-/**
- * \brief Transforms a range of tasks into a vector of futures
- * 
- * \tparam Range Type of the task range
- * \tparam Args Argument types for the tasks
- * \param range Container of tasks
- * \param tArgs Arguments to pass to each task
- * \return std::vector<std::shared_future<result_type>> Vector of futures
- */
-template<typename Range, typename... Args>
-auto transform(const Range& range, const std::tuple<Args...>& tArgs)
-    -> std::vector<std::shared_future<typename Range::value_type::return_type>>
-{
-    using result_type = typename Range::value_type::return_type;
-    std::vector<std::shared_future<result_type>> funcs;
-    funcs.reserve(range.size());
-
-    for (const auto& task : range)
-    {
-        funcs.emplace_back(std::apply([&task](const auto&...args) { return task.run(args...); }, tArgs));
-    }
-    return funcs;
-}
-
-/**
- * \brief Waits for any task to complete and returns the first valid result
- * 
- * \tparam Range Type of future container
- * \param funcs Container of futures
- * \param timeout Maximum duration to wait
- * \return std::pair<int, std::optional<result_type>> Index and result of the completed task (-1 if none)
- */
-template<typename Range>
-auto getAnyResultPair(Range&& funcs, std::chrono::milliseconds timeout)
-    -> std::pair<int, std::optional<range_trait_t<typename std::decay_t<decltype(*std::begin(funcs))>>>>
-{
-    using result_type = range_trait_t<typename std::decay_t<decltype(*std::begin(funcs))>>;
-    using result_pair = std::pair<int, std::optional<result_type>>;
-
-    std::promise<result_pair> resPro;
-    auto resfut = resPro.get_future();
-    auto sharedData = std::make_shared<std::atomic<bool>>(false);
-    const size_t count = funcs.size();
-    auto isFinished = std::make_shared<std::vector<std::atomic<bool>>>(count);
-    for (size_t i = 0; i < count; ++i)
-    {
-        (*isFinished)[i] = false;
-    }
-
-    auto start_time = std::chrono::steady_clock::now();
-
-    std::thread monitor(
-        [funcs = std::forward<Range>(funcs),
-         resPro = std::move(resPro),
-         sharedData,
-         isFinished,
-         count,
-         timeout,
-         start_time]() mutable
-        {
-            size_t completed = 0;
-            while (completed < count && !sharedData->load())
-            {
-                if (timeout.count() > 0)
-                {
-                    auto current_time = std::chrono::steady_clock::now();
-                    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(current_time - start_time);
-                    if (elapsed >= timeout)
-                    {
-                        break;
-                    }
-                }
-
-                for (size_t i = 0; i < count; ++i)
-                {
-                    if ((*isFinished)[i])
-                    {
-                        continue;
-                    }
-
-                    if (funcs[i].wait_for(std::chrono::milliseconds(1)) == std::future_status::ready)
-                    {
-                        try
-                        {
-                            auto res = funcs[i].get();
-                            (*isFinished)[i] = true;
-                            ++completed;
-                            if (!sharedData->exchange(true))
-                            {
-                                resPro.set_value(std::make_pair(static_cast<int>(i), std::move(res)));
-                                return;
-                            }
-                        }
-                        catch (...)
-                        {
-                            (*isFinished)[i] = true;
-                            ++completed;
-                        }
-                    }
-                }
-            }
-
-            if (!sharedData->exchange(true))
-            {
-                resPro.set_value(std::make_pair(-1, std::optional<result_type>()));
-            }
-        });
-
-    monitor.detach();
-    return resfut.get();
-}
-
-/**
- * \brief Waits for any task satisfying a condition to complete
- * 
- * \tparam Func Type of condition function
- * \tparam Range Type of future container
- * \param checkFun Condition function
- * \param funcs Container of futures
- * \param timeout Maximum duration to wait
- * \return std::pair<int, std::optional<result_type>> Index and result (if found, -1 if none)
- */
-template<typename Func, typename Range>
-auto getAnyWithResultPair(Func checkFun, Range&& funcs, std::chrono::milliseconds timeout)
-    -> std::pair<int, std::optional<range_trait_t<typename std::decay_t<decltype(*std::begin(funcs))>>>>
-{
-    using result_type = range_trait_t<typename std::decay_t<decltype(*std::begin(funcs))>>;
-    using result_pair = std::pair<int, std::optional<result_type>>;
-
-    std::promise<result_pair> resPro;
-    auto resfut = resPro.get_future();
-    auto sharedData = std::make_shared<std::atomic<bool>>(false);
-    const size_t count = funcs.size();
-    auto isFinished = std::make_shared<std::vector<std::atomic<bool>>>(count);
-    for (size_t i = 0; i < count; ++i)
-    {
-        (*isFinished)[i] = false;
-    }
-
-    auto start_time = std::chrono::steady_clock::now();
-
-    std::thread monitor(
-        [funcs = std::forward<Range>(funcs),
-         checkFun = std::move(checkFun),
-         resPro = std::move(resPro),
-         sharedData,
-         isFinished,
-         count,
-         timeout,
-         start_time]() mutable
-        {
-            size_t completed = 0;
-            while (completed < count && !sharedData->load())
-            {
-                if (timeout.count() > 0)
-                {
-                    auto current_time = std::chrono::steady_clock::now();
-                    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(current_time - start_time);
-                    if (elapsed >= timeout)
-                    {
-                        break;
-                    }
-                }
-
-                for (size_t i = 0; i < count; ++i)
-                {
-                    if ((*isFinished)[i])
-                    {
-                        continue;
-                    }
-
-                    if (funcs[i].wait_for(std::chrono::milliseconds(1)) == std::future_status::ready)
-                    {
-                        try
-                        {
-                            auto res = funcs[i].get();
-                            (*isFinished)[i] = true;
-                            ++completed;
-                            if (checkFun(res) && !sharedData->exchange(true))
-                            {
-                                resPro.set_value(std::make_pair(static_cast<int>(i), std::move(res)));
-                                return;
-                            }
-                        }
-                        catch (...)
-                        {
-                            (*isFinished)[i] = true;
-                            ++completed;
-                        }
-                    }
-                }
-            }
-
-            if (!sharedData->exchange(true))
-            {
-                resPro.set_value(std::make_pair(-1, std::optional<result_type>()));
-            }
-        });
-
-    monitor.detach();
-    return resfut.get();
-}
-
-/**
- * \brief Waits for the first task satisfying a condition in order
- * 
- * \tparam Func Type of condition function
- * \tparam Range Type of future container
- * \param checkFun Condition function
- * \param funcs Container of futures
- * \param timeout Maximum duration to wait
- * \return std::pair<int, std::optional<result_type>> Index and result (if found, -1 if none)
- */
-template<typename Func, typename Range>
-auto getOrderWithResultPair(Func&& checkFun, Range&& funcs, std::chrono::milliseconds timeout)
-    -> std::pair<int, std::optional<range_trait_t<typename std::decay_t<decltype(*std::begin(funcs))>>>>
-{
-    using result_type = range_trait_t<typename std::decay_t<decltype(*std::begin(funcs))>>;
-    auto start_time = std::chrono::steady_clock::now();
-    const int count = static_cast<int>(funcs.size());
-
-    for (int i = 0; i < count; ++i)
-    {
-        // Calculate remaining time
-        std::chrono::milliseconds remaining_time = std::chrono::milliseconds::max();
-        if (timeout.count() > 0)
-        {
-            auto current_time = std::chrono::steady_clock::now();
-            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(current_time - start_time);
-            if (elapsed >= timeout)
-            {
-                return {-1, std::optional<result_type>()};
-            }
-            remaining_time = timeout - elapsed;
-        }
-
-        // Wait for current task with timeout
-        auto status = funcs[i].wait_for(remaining_time);
-
-        if (status == std::future_status::timeout)
-        {
-            // Skip to next task on timeout
-            continue;
-        }
-
-        // Process result if ready
-        if (status == std::future_status::ready)
-        {
-            try
-            {
-                auto res = funcs[i].get();
-                if (checkFun(res))
-                {
-                    return {i, std::move(res)};
-                }
-            }
-            catch (...)
-            {
-                // Continue to next task on exception
-            }
-        }
-    }
-
-    return {-1, std::optional<result_type>()};
-}
-} // namespace aux
-
-/**
- * \brief Executes all tasks and collects their results
- * 
- * \tparam Range Type of task container
- * \tparam Args Argument types for the tasks
- * \param range Container of tasks
- * \param timeout Maximum duration to wait
- * \param args Arguments to pass to tasks
- * \return Task<std::optional<std::vector<result_type>>()> Task producing the results (nullopt on failure)
- */
-template<typename Range, typename... Args>
-inline auto All(const Range& range,
-                std::chrono::milliseconds timeout,
-                Args&&...args) -> Task<std::optional<std::vector<typename Range::value_type::return_type>>()>
-{
-    using result_type = typename Range::value_type::return_type;
-    using vector_type = std::vector<result_type>;
-
-    auto tArgs = std::make_tuple(std::forward<Args>(args)...);
-    return Task<std::optional<vector_type>()>(
-        [range, tArgs = std::move(tArgs), timeout]() mutable
-        {
-            try
-            {
-                auto funcs = aux::transform(range, tArgs);
-                vector_type res;
-                res.reserve(funcs.size());
-
-                auto start_time = std::chrono::steady_clock::now();
-
-                for (auto& fut : funcs)
-                {
-                    // Calculate remaining time for this task
-                    std::chrono::milliseconds remaining_time = std::chrono::milliseconds::max();
-                    if (timeout.count() > 0)
-                    {
-                        auto current_time = std::chrono::steady_clock::now();
-                        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(current_time - start_time);
-                        if (elapsed >= timeout)
-                        {
-                            return std::optional<vector_type>(std::nullopt);
-                        }
-                        remaining_time = timeout - elapsed;
-                    }
-
-                    // Wait for this task to complete
-                    if (fut.wait_for(remaining_time) != std::future_status::ready)
-                    {
-                        return std::optional<vector_type>(std::nullopt);
-                    }
-
-                    // Get result
-                    res.emplace_back(fut.get());
-                }
-                return std::optional<vector_type>(std::move(res));
-            }
-            catch (...)
-            {
-                return std::optional<vector_type>(std::nullopt);
-            }
-        });
-}
-
-/**
- * \brief Executes all tasks and returns the best result according to a comparator
- * 
- * \tparam Func Type of comparator function
- * \tparam Range Type of task container
- * \tparam Args Argument types for the tasks
- * \param fn Comparator function
- * \param range Container of tasks
- * \param timeout Maximum duration to wait
- * \param args Arguments to pass to tasks
- * \return Task<std::optional<result_type>()> Task producing the best result (nullopt on failure)
- */
-template<typename Func, typename Range, typename... Args>
-inline auto Best(Func fn, const Range& range, std::chrono::milliseconds timeout, Args&&...args)
-    -> Task<std::optional<typename Range::value_type::return_type>()>
-{
-    using result_type = typename Range::value_type::return_type;
-
-    return All(range, timeout, std::forward<Args>(args)...)
-        .then(
-            [fn = std::move(fn)](std::optional<std::vector<result_type>> tmpRes)
-            {
-                if (!tmpRes || tmpRes->empty())
-                {
-                    return std::optional<result_type>(std::nullopt);
-                }
-                auto best = std::min_element(tmpRes->begin(),
-                                             tmpRes->end(),
-                                             [&fn](const result_type& a, const result_type& b) { return fn(a, b); });
-                return std::optional<result_type>(std::move(*best));
-            });
-}
-
-/**
- * \brief Executes tasks and returns the first completed result
- * 
- * \tparam Range Type of task container
- * \tparam Args Argument types for the tasks
- * \param range Container of tasks
- * \param timeout Maximum duration to wait
- * \param args Arguments to pass to tasks
- * \return Task<std::pair<int, std::optional<result_type>>()> Task producing index and result (-1 on failure)
- */
-template<typename Range, typename... Args>
-inline auto Any(const Range& range,
-                std::chrono::milliseconds timeout,
-                Args&&...args) -> Task<std::pair<int, std::optional<typename Range::value_type::return_type>>()>
-{
-    using result_type = typename Range::value_type::return_type;
-    using pair_type = std::pair<int, std::optional<result_type>>;
-
-    return Task<pair_type()>(
-        [range, timeout, tArgs = std::make_tuple(std::forward<Args>(args)...)]() mutable
-        {
-            try
-            {
-                auto funcs = aux::transform(range, tArgs);
-                return aux::getAnyResultPair(std::move(funcs), timeout);
-            }
-            catch (...)
-            {
-                return std::make_pair(-1, std::optional<result_type>());
-            }
-        });
-}
-
-/**
- * \brief Executes tasks and returns the first result satisfying a condition
- * 
- * \tparam Func Type of condition function
- * \tparam Range Type of task container
- * \tparam Args Argument types for the tasks
- * \param fn Condition function
- * \param range Container of tasks
- * \param timeout Maximum duration to wait
- * \param args Arguments to pass to tasks
- * \return Task<std::pair<int, std::optional<result_type>>()> Task producing index and result (-1 on failure)
- */
-template<typename Func, typename Range, typename... Args>
-inline auto AnyWith(Func fn, const Range& range, std::chrono::milliseconds timeout, Args&&...args)
-    -> Task<std::pair<int, std::optional<typename Range::value_type::return_type>>()>
-{
-    using result_type = typename Range::value_type::return_type;
-    using pair_type = std::pair<int, std::optional<result_type>>;
-
-    return Task<pair_type()>(
-        [range, fn = std::move(fn), timeout, tArgs = std::make_tuple(std::forward<Args>(args)...)]() mutable
-        {
-            try
-            {
-                auto funcs = aux::transform(range, tArgs);
-                return aux::getAnyWithResultPair(std::move(fn), std::move(funcs), timeout);
-            }
-            catch (...)
-            {
-                return std::make_pair(-1, std::optional<result_type>());
-            }
-        });
-}
-
-/**
- * \brief Executes tasks in order and returns the first result satisfying a condition
- * 
- * \tparam Func Type of condition function
- * \tparam Range Type of task container
- * \tparam Args Argument types for the tasks
- * \param fn Condition function
- * \param range Container of tasks
- * \param timeout Maximum duration to wait
- * \param args Arguments to pass to tasks
- * \return Task<std::pair<int, std::optional<result_type>>()> Task producing index and result (-1 on failure)
- */
-template<typename Func, typename Range, typename... Args>
-inline auto OrderWith(Func fn, const Range& range, std::chrono::milliseconds timeout, Args&&...args)
-    -> Task<std::pair<int, std::optional<typename Range::value_type::return_type>>()>
-{
-    using result_type = typename Range::value_type::return_type;
-    using pair_type = std::pair<int, std::optional<result_type>>;
-
-    return Task<pair_type()>(
-        [range, fn = std::move(fn), timeout, tArgs = std::make_tuple(std::forward<Args>(args)...)]() mutable
-        {
-            try
-            {
-                auto funcs = aux::transform(range, tArgs);
-                return aux::getOrderWithResultPair(std::move(fn), std::move(funcs), timeout);
-            }
-            catch (...)
-            {
-                return std::make_pair(-1, std::optional<result_type>());
-            }
-        });
-}
-
-/**
- * \brief Manages and executes groups of tasks with various strategies
- * 
- * \tparam Ret Return type of the tasks
- * \tparam Args Argument types for the tasks
- */
-template<typename Ret, typename... Args>
-class Worker
-{
-public:
-    using TaskType = Task<Ret(Args...)>;
-    using ConditionType = std::function<bool(Ret)>;
-    using ComparatorType = std::function<bool(Ret, Ret)>;
-
-    /**
-     * \brief Adds a function to the worker
-     * 
-     * \param name Name identifier for the function
-     * \param fn Function to add
-     */
-    template<typename Fn>
-    void add_function(const std::string& name, Fn&& fn)
-    {
-        tasks_.emplace_back(name, TaskType(std::forward<Fn>(fn)));
-    }
-
-    /**
-     * \brief Adds a member function to the worker
-     * 
-     * \tparam MemFn Member function type
-     * \tparam Obj Object type
-     * \param name Name identifier for the function
-     * \param mem_fn Pointer to member function
-     * \param obj Object instance to bind
-     */
-    template<typename MemFn, typename Obj>
-    void add_function(const std::string& name, MemFn mem_fn, Obj&& obj)
-    {
-        tasks_.emplace_back(name,
-                            TaskType([mem_fn, obj = std::forward<Obj>(obj)](Args... args) -> Ret
-                                     { return (obj->*mem_fn)(std::forward<Args>(args)...); }));
-    }
-
-    /**
-     * \brief Executes any task and returns the first completed result
-     * 
-     * \param args Arguments for the tasks
-     * \param timeout Maximum duration to wait
-     * \return std::optional<std::pair<std::string, Ret>> Name and result of completed task
-     */
-    std::optional<std::pair<std::string, Ret>> execute_any(
-        Args... args, std::chrono::steady_clock::duration timeout = std::chrono::seconds(0))
-    {
-        if (tasks_.empty())
-        {
-            return std::nullopt;
-        }
-
-        auto ms_timeout = std::chrono::duration_cast<std::chrono::milliseconds>(timeout);
-        auto any_task = Any(tasks_vector(), ms_timeout, std::forward<Args>(args)...);
-        auto fut = any_task.run();
-
-        try
-        {
-            auto [index, result_opt] = fut.get();
-            if (index >= 0 && result_opt && static_cast<size_t>(index) < tasks_.size())
-            {
-                return std::make_pair(tasks_[index].first, *result_opt);
-            }
-            return std::nullopt;
-        }
-        catch (...)
-        {
-            return std::nullopt;
-        }
-    }
-
-    /**
-     * \brief Executes tasks and returns the first result satisfying a condition
-     * 
-     * \param condition Condition function
-     * \param args Arguments for the tasks
-     * \param timeout Maximum duration to wait
-     * \return std::optional<std::pair<std::string, Ret>> Name and result of completed task
-     */
-    std::optional<std::pair<std::string, Ret>> execute_any_with(
-        ConditionType condition, Args... args, std::chrono::steady_clock::duration timeout = std::chrono::seconds(0))
-    {
-        if (tasks_.empty())
-        {
-            return std::nullopt;
-        }
-
-        auto ms_timeout = std::chrono::duration_cast<std::chrono::milliseconds>(timeout);
-        auto any_with_task = AnyWith(condition, tasks_vector(), ms_timeout, std::forward<Args>(args)...);
-        auto fut = any_with_task.run();
-
-        auto [index, result_opt] = fut.get();
-        if (index >= 0 && result_opt && static_cast<size_t>(index) < tasks_.size())
-        {
-            return std::make_pair(tasks_[static_cast<size_t>(index)].first, *result_opt);
-        }
-        return std::nullopt;
-    }
-
-    /**
-     * \brief Executes all tasks and returns their results
-     * 
-     * \param args Arguments for the tasks
-     * \param timeout Maximum duration to wait
-     * \return std::vector<std::pair<std::string, Ret>> Names and results of all tasks
-     */
-    std::vector<std::pair<std::string, Ret>> execute_all(
-        Args... args, std::chrono::steady_clock::duration timeout = std::chrono::seconds(0))
-    {
-        std::vector<std::pair<std::string, Ret>> results;
-        if (tasks_.empty())
-        {
-            return results;
-        }
-
-        auto ms_timeout = std::chrono::duration_cast<std::chrono::milliseconds>(timeout);
-        auto all_task = All(tasks_vector(), ms_timeout, std::forward<Args>(args)...);
-        auto fut = all_task.run();
-
-        try
-        {
-            auto task_results_opt = fut.get();
-            if (task_results_opt)
-            {
-                auto& task_results = *task_results_opt;
-                for (size_t i = 0; i < task_results.size() && i < tasks_.size(); ++i)
-                {
-                    results.emplace_back(tasks_[i].first, task_results[i]);
-                }
-            }
-        }
-        catch (...)
-        {
-            // Return empty results on failure
-        }
-        return results;
-    }
-
-    /**
-     * \brief Executes all tasks and returns the best result
-     * 
-     * \param comparator Comparator function
-     * \param args Arguments for the tasks
-     * \param timeout Maximum duration to wait
-     * \return std::optional<std::pair<std::string, Ret>> Name and result of best task
-     */
-    std::optional<std::pair<std::string, Ret>> execute_best(
-        ComparatorType comparator, Args... args, std::chrono::steady_clock::duration timeout = std::chrono::seconds(0))
-    {
-        if (tasks_.empty())
-        {
-            return std::nullopt;
-        }
-
-        auto ms_timeout = std::chrono::duration_cast<std::chrono::milliseconds>(timeout);
-        auto best_task = Best(comparator, tasks_vector(), ms_timeout, std::forward<Args>(args)...);
-        auto fut = best_task.run();
-
-        try
-        {
-            auto result_opt = fut.get();
-            if (!result_opt)
-            {
-                return std::nullopt;
-            }
-
-            // Find which task produced the best result
-            auto results = execute_all(args..., timeout);
-            for (auto& [name, value] : results)
-            {
-                if (value == *result_opt)
-                {
-                    return std::make_pair(name, value);
-                }
-            }
-            return std::nullopt;
-        }
-        catch (...)
-        {
-            return std::nullopt;
-        }
-    }
-
-    /**
-     * \brief Executes tasks in order and returns the first result satisfying a condition
-     * 
-     * \param condition Condition function
-     * \param args Arguments for the tasks
-     * \param timeout Maximum duration to wait
-     * \return std::optional<std::pair<std::string, Ret>> Name and result of completed task
-     */
-    std::optional<std::pair<std::string, Ret>> execute_order_with(
-        ConditionType condition, Args... args, std::chrono::steady_clock::duration timeout = std::chrono::seconds(0))
-    {
-        if (tasks_.empty())
-        {
-            return std::nullopt;
-        }
-
-        auto ms_timeout = std::chrono::duration_cast<std::chrono::milliseconds>(timeout);
-        auto order_with_task = OrderWith(condition, tasks_vector(), ms_timeout, std::forward<Args>(args)...);
-        auto fut = order_with_task.run();
-
-        auto [index, result_opt] = fut.get();
-        if (index >= 0 && result_opt && static_cast<size_t>(index) < tasks_.size())
-        {
-            return std::make_pair(tasks_[index].first, *result_opt);
-        }
-        return std::nullopt;
-    }
-
-private:
-    std::vector<TaskType> tasks_vector() const
-    {
-        std::vector<TaskType> tasks;
-        for (const auto& [_, task] : tasks_)
-        {
-            tasks.push_back(task);
-        }
-        return tasks;
-    }
-
-    std::vector<std::pair<std::string, TaskType>> tasks_;
-};
-} // namespace hyp
-
+#pragma once
+
+#ifndef _HYPARA_HPP_
+#define _HYPARA_HPP_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(HYPARA_ENABLE_COROUTINES) && defined(__cpp_impl_coroutine)
+#define HYPARA_COROUTINES 1
+#include <coroutine>
+#endif
+
+namespace hyp
+{
+class ThreadPool;
+
+namespace aux
+{
+/**
+ * \brief Recycles the small blocks of per-execution state: completion states, stop states and pool jobs
+ * 
+ * Blocks are cache-line aligned and grouped in size classes of one cache line. Each thread keeps
+ * a few blocks per class and trades them with a shared list in batches, since a block is usually
+ * allocated by the thread starting an execution and freed by the pool thread finishing it.
+ */
+class BlockPool
+{
+public:
+    static constexpr size_t block_align = 64;
+    static constexpr size_t class_count = 8; // Blocks of up to 512 bytes are recycled
+    static constexpr size_t batch = 32;
+
+    static void* allocate(size_t size)
+    {
+        const size_t sizeClass = size_class(size);
+        if (sizeClass >= class_count)
+        {
+            return ::operator new(size, std::align_val_t(block_align));
+        }
+
+        if (auto* cache = local())
+        {
+            auto& list = cache->lists[sizeClass];
+            if (!list.head)
+            {
+                std::lock_guard<std::mutex> lock(central().mutex);
+                list.take(central().lists[sizeClass], batch);
+            }
+            if (list.head)
+            {
+                return list.pop();
+            }
+        }
+        return ::operator new((sizeClass + 1) * block_align, std::align_val_t(block_align));
+    }
+
+    static void deallocate(void* ptr, size_t size) noexcept
+    {
+        const size_t sizeClass = size_class(size);
+        if (sizeClass >= class_count)
+        {
+            ::operator delete(ptr, std::align_val_t(block_align));
+            return;
+        }
+
+        auto* cache = local();
+        if (!cache)
+        {
+            // Freed during thread exit, after the thread's cache is gone
+            std::lock_guard<std::mutex> lock(central().mutex);
+            central().lists[sizeClass].push(ptr);
+            return;
+        }
+
+        auto& list = cache->lists[sizeClass];
+        list.push(ptr);
+        if (list.count > 2 * batch)
+        {
+            std::lock_guard<std::mutex> lock(central().mutex);
+            central().lists[sizeClass].take(list, batch);
+        }
+    }
+
+private:
+    struct FreeList
+    {
+        struct Node
+        {
+            Node* next;
+        };
+
+        void push(void* ptr) noexcept
+        {
+            head = ::new (ptr) Node{head};
+            ++count;
+        }
+
+        void* pop() noexcept
+        {
+            auto* node = head;
+            head = node->next;
+            --count;
+            return node;
+        }
+
+        void take(FreeList& other, size_t limit) noexcept
+        {
+            for (; other.head && limit > 0; --limit)
+            {
+                push(other.pop());
+            }
+        }
+
+        Node* head = nullptr;
+        size_t count = 0;
+    };
+
+    struct Central
+    {
+        std::mutex mutex;
+        std::array<FreeList, class_count> lists;
+    };
+
+    struct Cache
+    {
+        explicit Cache(bool& flag) noexcept : gone(flag)
+        {
+        }
+
+        ~Cache()
+        {
+            std::lock_guard<std::mutex> lock(central().mutex);
+            for (size_t i = 0; i < class_count; ++i)
+            {
+                central().lists[i].take(lists[i], lists[i].count);
+            }
+            gone = true;
+        }
+
+        bool& gone;
+        std::array<FreeList, class_count> lists;
+    };
+
+    static size_t size_class(size_t size) noexcept
+    {
+        return size == 0 ? 0 : (size - 1) / block_align;
+    }
+
+    static Central& central()
+    {
+        // Never destroyed, since blocks may still be freed during static destruction
+        static auto* central = new Central();
+        return *central;
+    }
+
+    static Cache* local() noexcept
+    {
+        static thread_local bool gone = false;
+        if (gone)
+        {
+            return nullptr;
+        }
+        static thread_local Cache cache(gone);
+        return &cache;
+    }
+};
+
+/**
+ * \brief Allocator drawing from the BlockPool, for std::allocate_shared
+ * 
+ * \tparam T Type of the allocated objects
+ */
+template<typename T>
+struct PoolAllocator
+{
+    using value_type = T;
+
+    PoolAllocator() = default;
+
+    template<typename U>
+    PoolAllocator(const PoolAllocator<U>&) noexcept
+    {
+    }
+
+    T* allocate(size_t n)
+    {
+        if constexpr (alignof(T) > BlockPool::block_align)
+        {
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+        }
+        else
+        {
+            return static_cast<T*>(BlockPool::allocate(n * sizeof(T)));
+        }
+    }
+
+    void deallocate(T* ptr, size_t n) noexcept
+    {
+        if constexpr (alignof(T) > BlockPool::block_align)
+        {
+            ::operator delete(ptr, std::align_val_t(alignof(T)));
+        }
+        else
+        {
+            BlockPool::deallocate(ptr, n * sizeof(T));
+        }
+    }
+
+    template<typename U>
+    bool operator==(const PoolAllocator<U>&) const noexcept
+    {
+        return true;
+    }
+
+    template<typename U>
+    bool operator!=(const PoolAllocator<U>&) const noexcept
+    {
+        return false;
+    }
+};
+
+/**
+ * \brief std::make_shared drawing the object and its control block from the BlockPool
+ */
+template<typename T, typename... Args>
+std::shared_ptr<T> make_pooled(Args&&...args)
+{
+    return std::allocate_shared<T>(PoolAllocator<T>(), std::forward<Args>(args)...);
+}
+
+/**
+ * \brief Unit of work scheduled on a ThreadPool
+ * 
+ * Jobs manage their own storage: run() and cancel() are each called at most once,
+ * and the pool never touches a job afterwards.
+ */
+class Job
+{
+public:
+    virtual ~Job() = default;
+
+    /**
+     * \brief Executes the job
+     */
+    virtual void run() noexcept = 0;
+
+    /**
+     * \brief Disposes of a job that will never run
+     */
+    virtual void cancel() noexcept = 0;
+
+    // Jobs are allocated per launch, so heap-allocated ones are recycled
+    static void* operator new(size_t size)
+    {
+        return BlockPool::allocate(size);
+    }
+
+    static void* operator new(size_t size, std::align_val_t align)
+    {
+        return static_cast<size_t>(align) > BlockPool::block_align ? ::operator new(size, align)
+                                                                   : BlockPool::allocate(size);
+    }
+
+    static void operator delete(void* ptr, size_t size) noexcept
+    {
+        BlockPool::deallocate(ptr, size);
+    }
+
+    static void operator delete(void* ptr, size_t size, std::align_val_t align) noexcept
+    {
+        if (static_cast<size_t>(align) > BlockPool::block_align)
+        {
+            ::operator delete(ptr, align);
+        }
+        else
+        {
+            BlockPool::deallocate(ptr, size);
+        }
+    }
+
+private:
+    friend class hyp::ThreadPool;
+
+    Job* m_next = nullptr; // Link in the pool's injection queue
+};
+
+/**
+ * \brief Heap-allocated job wrapping a callable
+ * 
+ * \tparam Fn Type of the callable, invoked without arguments
+ */
+template<typename Fn>
+class FunctionJob final : public Job
+{
+public:
+    template<typename F>
+    explicit FunctionJob(F&& fn) : m_fn(std::forward<F>(fn))
+    {
+    }
+
+    void run() noexcept override
+    {
+        std::unique_ptr<FunctionJob> self(this);
+        try
+        {
+            m_fn();
+        }
+        catch (...)
+        {
+        } // Jobs report their own errors
+    }
+
+    void cancel() noexcept override
+    {
+        delete this;
+    }
+
+private:
+    Fn m_fn;
+};
+
+/**
+ * \brief Fixed-capacity Chase-Lev work-stealing deque
+ * 
+ * The owning thread pushes and pops at the bottom, other threads steal from the top.
+ */
+class WorkStealingDeque
+{
+public:
+    static constexpr int64_t capacity = 4096;
+
+    WorkStealingDeque() : m_buffer(new std::atomic<Job*>[capacity])
+    {
+    }
+
+    /**
+     * \brief Pushes a job at the bottom, owner thread only
+     * 
+     * \return bool False if the deque is full
+     */
+    bool push(Job* job) noexcept
+    {
+        const int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+        const int64_t top = m_top.load(std::memory_order_acquire);
+        if (bottom - top >= capacity)
+        {
+            return false;
+        }
+
+        m_buffer[static_cast<size_t>(bottom & mask)].store(job, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * \brief Pops the most recently pushed job, owner thread only
+     * 
+     * \return Job* Job, or nullptr if the deque is empty
+     */
+    Job* pop() noexcept
+    {
+        const int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+        m_bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = m_top.load(std::memory_order_relaxed);
+
+        if (top > bottom)
+        {
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        Job* job = m_buffer[static_cast<size_t>(bottom & mask)].load(std::memory_order_relaxed);
+        if (top == bottom)
+        {
+            // Last job: race against thieves for it
+            if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                job = nullptr;
+            }
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return job;
+    }
+
+    /**
+     * \brief Steals the oldest job, any thread
+     * 
+     * \return Job* Job, or nullptr if the deque is empty
+     */
+    Job* steal() noexcept
+    {
+        for (;;)
+        {
+            int64_t top = m_top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const int64_t bottom = m_bottom.load(std::memory_order_acquire);
+            if (top >= bottom)
+            {
+                return nullptr;
+            }
+
+            Job* job = m_buffer[static_cast<size_t>(top & mask)].load(std::memory_order_relaxed);
+            if (m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                return job;
+            }
+            // Lost the race to another thief or the owner, retry
+        }
+    }
+
+private:
+    static constexpr int64_t mask = capacity - 1;
+
+    alignas(64) std::atomic<int64_t> m_top{0};
+    alignas(64) std::atomic<int64_t> m_bottom{0};
+    std::unique_ptr<std::atomic<Job*>[]> m_buffer;
+};
+} // namespace aux
+
+/**
+ * \brief Fixed-size work-stealing pool of worker threads that tasks are executed on
+ * 
+ * Every worker owns a deque: jobs submitted from a worker go to its own deque and are popped
+ * newest first, so nested submissions stay on the submitting thread. Jobs submitted from
+ * outside the pool go to a shared injection queue. Idle workers take from the injection queue
+ * and steal the oldest jobs of randomly chosen victims.
+ */
+class ThreadPool
+{
+public:
+    /**
+     * \brief Starts the worker threads of the pool
+     * 
+     * \param threads Number of worker threads (0 selects default_concurrency())
+     */
+    explicit ThreadPool(size_t threads = default_concurrency())
+    {
+        if (threads == 0)
+        {
+            threads = default_concurrency();
+        }
+
+        m_queues.reserve(threads);
+        for (size_t i = 0; i < threads; ++i)
+        {
+            m_queues.emplace_back(std::make_unique<aux::WorkStealingDeque>());
+        }
+
+        m_threads.reserve(threads);
+        for (size_t i = 0; i < threads; ++i)
+        {
+            m_threads.emplace_back([this, i]() { loop(i); });
+        }
+    }
+
+    /**
+     * \brief Stops the pool, dropping jobs that have not started yet
+     */
+    ~ThreadPool()
+    {
+        m_stop.store(true);
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+        }
+        m_sleepCv.notify_all();
+        m_spareCv.notify_all();
+
+        for (auto& thread : m_threads)
+        {
+            thread.join();
+        }
+        {
+            // Workers have stopped, so no spare thread is started any more
+            std::lock_guard<std::mutex> lock(m_spareMutex);
+            for (auto& thread : m_spares)
+            {
+                thread.join();
+            }
+        }
+
+        for (auto& queue : m_queues)
+        {
+            while (auto* job = queue->steal())
+            {
+                job->cancel();
+            }
+        }
+        while (auto* job = pop_injected())
+        {
+            job->cancel();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * \brief Queues a job for execution on one of the worker threads
+     * 
+     * \tparam Fn Type of the job, must be callable without arguments
+     * \param fn Job to execute
+     */
+    template<typename Fn>
+    void submit(Fn&& fn)
+    {
+        submit(static_cast<aux::Job*>(new aux::FunctionJob<std::decay_t<Fn>>(std::forward<Fn>(fn))));
+    }
+
+    /**
+     * \brief Queues a job for execution on one of the worker threads
+     * 
+     * \param job Job to execute, must stay alive until it has run or been cancelled
+     */
+    void submit(aux::Job* job)
+    {
+        if (current_pool() != this || current_index() == no_queue || !m_queues[current_index()]->push(job))
+        {
+            std::lock_guard<std::mutex> lock(m_injectMutex);
+            job->m_next = nullptr;
+            (m_injectTail ? m_injectTail->m_next : m_injectHead) = job;
+            m_injectTail = job;
+        }
+
+        m_epoch.fetch_add(1);
+        if (m_sleepers.load() > 0)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_sleepMutex);
+            }
+            m_sleepCv.notify_one();
+        }
+        if (m_blocked.load() > 0)
+        {
+            wake_spares();
+        }
+    }
+
+    /**
+     * \brief Runs one queued job on the calling thread
+     * 
+     * \return bool False if there was no queued job
+     */
+    bool run_pending()
+    {
+        if (auto* job = find_job())
+        {
+            job->run();
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * \brief Marks the calling thread as blocked while alive, so a spare thread runs queued jobs in its stead
+     * 
+     * A pool thread that waits without running queued jobs, e.g. until a deadline, would otherwise
+     * hold back the jobs queued behind it, and block for good if it waits on them. Spare threads
+     * are started on demand, parked once the threads they stand in for resume, and reused later.
+     */
+    class Blocking
+    {
+    public:
+        /**
+         * \brief Marks the calling thread as blocked if it belongs to a pool
+         */
+        Blocking() : m_pool(current())
+        {
+            if (m_pool)
+            {
+                m_pool->block();
+            }
+        }
+
+        ~Blocking()
+        {
+            if (m_pool)
+            {
+                m_pool->unblock();
+            }
+        }
+
+        Blocking(const Blocking&) = delete;
+        Blocking& operator=(const Blocking&) = delete;
+
+    private:
+        ThreadPool* m_pool;
+    };
+
+    /**
+     * \brief Number of worker threads
+     */
+    size_t size() const noexcept
+    {
+        return m_threads.size();
+    }
+
+    /**
+     * \brief Number of tasks skipped because stop was requested before they started
+     */
+    size_t cancelled() const noexcept
+    {
+        return m_cancelled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * \brief Pool owning the calling thread
+     * 
+     * \return ThreadPool* Pool, or nullptr if called from a thread outside any pool
+     */
+    static ThreadPool* current() noexcept
+    {
+        return current_pool();
+    }
+
+    /**
+     * \brief Process-wide pool used by tasks that are not bound to a specific pool
+     */
+    static ThreadPool& global()
+    {
+        // Intentionally leaked: jobs still running at exit must not block process shutdown
+        static ThreadPool* pool = new ThreadPool();
+        return *pool;
+    }
+
+    /**
+     * \brief Default number of worker threads
+     * 
+     * Tasks commonly block (sleep, I/O), so the pool never shrinks below 16 threads on small machines.
+     */
+    static size_t default_concurrency() noexcept
+    {
+        return std::max<size_t>(std::thread::hardware_concurrency(), 16);
+    }
+
+private:
+    template<typename T>
+    friend class Task;
+
+    template<typename Signature, typename... Fns>
+    friend class StaticWorker;
+
+    // Index of spare threads, which own no queue
+    static constexpr size_t no_queue = std::numeric_limits<size_t>::max();
+
+    void note_cancelled() noexcept
+    {
+        m_cancelled.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void block()
+    {
+        const size_t blocked = m_blocked.fetch_add(1) + 1;
+        {
+            std::lock_guard<std::mutex> lock(m_spareMutex);
+            if (m_spares.size() < blocked && !m_stop.load())
+            {
+                m_spares.emplace_back([this, rank = m_spares.size()]() { spare_loop(rank); });
+            }
+        }
+        m_epoch.fetch_add(1);
+        wake_spares();
+    }
+
+    void unblock()
+    {
+        m_blocked.fetch_sub(1);
+        m_epoch.fetch_add(1);
+        wake_spares();
+    }
+
+    void wake_spares()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+        }
+        m_spareCv.notify_all();
+    }
+
+    static ThreadPool*& current_pool() noexcept
+    {
+        thread_local ThreadPool* pool = nullptr;
+        return pool;
+    }
+
+    static size_t& current_index() noexcept
+    {
+        thread_local size_t index = 0;
+        return index;
+    }
+
+    static uint32_t next_random() noexcept
+    {
+        // xorshift32, seeded per thread
+        thread_local uint32_t state =
+            static_cast<uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id())) | 1u;
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    /**
+     * \brief Unlinks the oldest injected job, m_injectMutex must be held
+     */
+    aux::Job* pop_injected() noexcept
+    {
+        auto* job = m_injectHead;
+        if (job)
+        {
+            m_injectHead = job->m_next;
+            if (!m_injectHead)
+            {
+                m_injectTail = nullptr;
+            }
+        }
+        return job;
+    }
+
+    aux::Job* find_job()
+    {
+        const bool is_worker = current_pool() == this && current_index() != no_queue;
+        if (is_worker)
+        {
+            if (auto* job = m_queues[current_index()]->pop())
+            {
+                return job;
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_injectMutex);
+            if (auto* job = pop_injected())
+            {
+                return job;
+            }
+        }
+
+        // Visit every victim once, starting at a random one
+        const size_t count = m_queues.size();
+        const size_t start = next_random() % count;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const size_t victim = (start + i) % count;
+            if (is_worker && victim == current_index())
+            {
+                continue;
+            }
+            if (auto* job = m_queues[victim]->steal())
+            {
+                return job;
+            }
+        }
+        return nullptr;
+    }
+
+    void loop(size_t index)
+    {
+        current_pool() = this;
+        current_index() = index;
+        while (!m_stop.load())
+        {
+            const auto epoch = m_epoch.load();
+            if (auto* job = find_job())
+            {
+                job->run();
+                continue;
+            }
+
+            // Sleep until something is submitted after the scan above
+            std::unique_lock<std::mutex> lock(m_sleepMutex);
+            m_sleepers.fetch_add(1);
+            m_sleepCv.wait(lock, [this, epoch]() { return m_stop.load() || m_epoch.load() != epoch; });
+            m_sleepers.fetch_sub(1);
+        }
+    }
+
+    /**
+     * \brief Loop of the spare thread of the given rank, running jobs while more threads are blocked
+     */
+    void spare_loop(size_t rank)
+    {
+        current_pool() = this;
+        current_index() = no_queue;
+        while (!m_stop.load())
+        {
+            const auto epoch = m_epoch.load();
+            if (m_blocked.load() > rank)
+            {
+                if (auto* job = find_job())
+                {
+                    job->run();
+                    continue;
+                }
+            }
+
+            // Spares wait apart, so they never take the wake-up of a sleeping worker
+            std::unique_lock<std::mutex> lock(m_sleepMutex);
+            m_spareCv.wait(lock, [this, epoch]() { return m_stop.load() || m_epoch.load() != epoch; });
+        }
+    }
+
+    std::vector<std::unique_ptr<aux::WorkStealingDeque>> m_queues;
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_spareMutex;
+    std::vector<std::thread> m_spares; // Grows to the largest number of threads blocked at once
+    std::atomic<size_t> m_blocked{0};
+
+    std::mutex m_injectMutex;
+    aux::Job* m_injectHead = nullptr; // Intrusive FIFO, so submitting never allocates
+    aux::Job* m_injectTail = nullptr;
+
+    std::mutex m_sleepMutex;
+    std::condition_variable m_sleepCv;
+    std::condition_variable m_spareCv;
+    std::atomic<size_t> m_sleepers{0};
+    std::atomic<uint64_t> m_epoch{0};
+    std::atomic<bool> m_stop{false};
+    std::atomic<size_t> m_cancelled{0};
+};
+
+namespace aux
+{
+/**
+ * \brief Mutex and condition variable shared by the futures whose address hashes to it
+ */
+struct alignas(64) ParkingBucket
+{
+    std::mutex mutex;
+    std::condition_variable cv;
+};
+
+inline ParkingBucket& parking_bucket(const void* address) noexcept
+{
+    // Never destroyed, since pool threads may still complete futures during static destruction
+    static auto* buckets = new std::array<ParkingBucket, 64>();
+    return (*buckets)[(reinterpret_cast<std::uintptr_t>(address) >> 6) % buckets->size()];
+}
+
+/**
+ * \brief Shared state of a Future, allocated together with the job producing its result
+ * 
+ * One atomic word holds the state, and waiters park on a shared bucket only once they find it
+ * pending, like a futex: completing a state nobody waits on is a single atomic exchange.
+ * 
+ * \tparam Ret Result type
+ */
+template<typename Ret>
+class SharedState : public Job
+{
+public:
+    struct Unit
+    {
+    };
+    using value_type = std::conditional_t<std::is_void_v<Ret>, Unit, Ret>;
+
+    void retain() noexcept
+    {
+        m_refs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void release() noexcept
+    {
+        if (m_refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            delete this;
+        }
+    }
+
+    bool ready() const noexcept
+    {
+        return (m_state.load(std::memory_order_acquire) & ready_bit) != 0;
+    }
+
+    void wait() const
+    {
+        if (ready())
+        {
+            return;
+        }
+        auto& bucket = parking_bucket(this);
+        std::unique_lock<std::mutex> lock(bucket.mutex);
+        while ((m_state.fetch_or(waiting_bit, std::memory_order_acq_rel) & ready_bit) == 0)
+        {
+            bucket.cv.wait(lock);
+        }
+    }
+
+    template<typename Clock, typename Duration>
+    bool wait_until(const std::chrono::time_point<Clock, Duration>& until) const
+    {
+        if (ready() || Clock::now() >= until)
+        {
+            return ready();
+        }
+        auto& bucket = parking_bucket(this);
+        std::unique_lock<std::mutex> lock(bucket.mutex);
+        while ((m_state.fetch_or(waiting_bit, std::memory_order_acq_rel) & ready_bit) == 0)
+        {
+            if (bucket.cv.wait_until(lock, until) == std::cv_status::timeout)
+            {
+                return ready();
+            }
+        }
+        return true;
+    }
+
+    const std::exception_ptr& error() const noexcept
+    {
+        return m_error;
+    }
+
+    const value_type& value() const noexcept
+    {
+        return *m_value;
+    }
+
+    void cancel() noexcept override
+    {
+        m_error = std::make_exception_ptr(std::future_error(std::future_errc::broken_promise));
+        publish();
+        release();
+    }
+
+protected:
+    /**
+     * \brief Stores the result of a callable, or the exception it threw, and wakes the waiters
+     */
+    template<typename Fn>
+    void complete(Fn& fn) noexcept
+    {
+        try
+        {
+            if constexpr (std::is_void_v<Ret>)
+            {
+                fn();
+                m_value.emplace();
+            }
+            else
+            {
+                m_value.emplace(fn());
+            }
+        }
+        catch (...)
+        {
+            m_error = std::current_exception();
+        }
+        publish();
+    }
+
+private:
+    void publish() noexcept
+    {
+        auto& bucket = parking_bucket(this);
+        if ((m_state.exchange(ready_bit, std::memory_order_acq_rel) & waiting_bit) != 0)
+        {
+            // Taking the lock orders this wake-up after the waiter started waiting
+            {
+                std::lock_guard<std::mutex> lock(bucket.mutex);
+            }
+            bucket.cv.notify_all();
+        }
+    }
+
+    static constexpr uint32_t ready_bit = 1;
+    static constexpr uint32_t waiting_bit = 2;
+
+    mutable std::atomic<uint32_t> m_state{0};
+    std::atomic<uint32_t> m_refs{2}; // The future and the pending job
+    std::optional<value_type> m_value;
+    std::exception_ptr m_error;
+};
+
+/**
+ * \brief Shared state running a callable as a pool job
+ * 
+ * \tparam Ret Result type
+ * \tparam Fn Type of the callable, invoked without arguments
+ */
+template<typename Ret, typename Fn>
+class TaskState final : public SharedState<Ret>
+{
+public:
+    template<typename F>
+    explicit TaskState(F&& fn) : m_fn(std::forward<F>(fn))
+    {
+    }
+
+    void run() noexcept override
+    {
+        this->complete(*m_fn);
+        m_fn.reset(); // Drops the captured arguments while futures may still hold the result
+        this->release();
+    }
+
+private:
+    std::optional<Fn> m_fn;
+};
+
+/**
+ * \brief Lightweight shared future, the result of Task::spawn
+ * 
+ * Mirrors the part of std::shared_future the combinators use, on a state that is a single
+ * allocation also serving as the pool job, where a promise takes three.
+ * 
+ * \tparam Ret Result type
+ */
+template<typename Ret>
+class Future
+{
+public:
+    Future() = default;
+
+    /**
+     * \brief Adopts one reference to a state
+     */
+    explicit Future(SharedState<Ret>* state) noexcept : m_state(state)
+    {
+    }
+
+    Future(const Future& other) noexcept : m_state(other.m_state)
+    {
+        if (m_state)
+        {
+            m_state->retain();
+        }
+    }
+
+    Future(Future&& other) noexcept : m_state(std::exchange(other.m_state, nullptr))
+    {
+    }
+
+    Future& operator=(Future other) noexcept
+    {
+        std::swap(m_state, other.m_state);
+        return *this;
+    }
+
+    ~Future()
+    {
+        if (m_state)
+        {
+            m_state->release();
+        }
+    }
+
+    bool valid() const noexcept
+    {
+        return m_state != nullptr;
+    }
+
+    void wait() const
+    {
+        m_state->wait();
+    }
+
+    template<typename Clock, typename Duration>
+    std::future_status wait_until(const std::chrono::time_point<Clock, Duration>& until) const
+    {
+        return m_state->wait_until(until) ? std::future_status::ready : std::future_status::timeout;
+    }
+
+    template<typename Rep, typename Period>
+    std::future_status wait_for(const std::chrono::duration<Rep, Period>& timeout) const
+    {
+        return wait_until(std::chrono::steady_clock::now() + timeout);
+    }
+
+    /**
+     * \brief Waits for the result and returns it, rethrowing the task's exception
+     * 
+     * \return const Ret& Result shared by all copies of the future
+     */
+    decltype(auto) get() const
+    {
+        m_state->wait();
+        if (m_state->error())
+        {
+            std::rethrow_exception(m_state->error());
+        }
+        if constexpr (!std::is_void_v<Ret>)
+        {
+            return (m_state->value());
+        }
+    }
+
+private:
+    SharedState<Ret>* m_state = nullptr;
+};
+
+} // namespace aux
+
+/**
+ * \brief Time limit of an execution: none, a budget counted from when the execution starts, or a fixed instant
+ * 
+ * Durations convert implicitly, keeping full steady_clock resolution; as before, a zero duration
+ * means no deadline. Deadline::within() expresses a real budget, where zero expires immediately.
+ */
+class Deadline
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    /**
+     * \brief No deadline
+     */
+    Deadline() noexcept = default;
+
+    /**
+     * \brief Budget counted from the start of the execution
+     * 
+     * \param timeout Budget, zero or negative for no deadline
+     */
+    template<typename Rep, typename Period>
+    Deadline(std::chrono::duration<Rep, Period> timeout) noexcept
+    {
+        if (timeout > timeout.zero())
+        {
+            set_budget(timeout);
+        }
+    }
+
+    /**
+     * \brief Fixed instant
+     * 
+     * \param at Instant at which the execution gives up
+     */
+    Deadline(clock::time_point at) noexcept : m_kind(Kind::At), m_at(at)
+    {
+    }
+
+    /**
+     * \brief No deadline
+     */
+    static Deadline none() noexcept
+    {
+        return Deadline();
+    }
+
+    /**
+     * \brief Budget counted from the start of the execution, where zero expires immediately
+     * 
+     * \param budget Budget, negative values count as zero
+     */
+    template<typename Rep, typename Period>
+    static Deadline within(std::chrono::duration<Rep, Period> budget) noexcept
+    {
+        Deadline deadline;
+        deadline.set_budget(std::max(budget, budget.zero()));
+        return deadline;
+    }
+
+    /**
+     * \brief Fixes a budget to an instant counted from now, other deadlines are returned as is
+     */
+    Deadline start() const noexcept
+    {
+        if (m_kind != Kind::Budget)
+        {
+            return *this;
+        }
+        const auto now = clock::now();
+        if (m_budget >= clock::time_point::max() - now)
+        {
+            return Deadline();
+        }
+        return Deadline(now + m_budget);
+    }
+
+    /**
+     * \brief Checks whether there is a deadline at all
+     */
+    bool is_set() const noexcept
+    {
+        return m_kind != Kind::None;
+    }
+
+    /**
+     * \brief Instant of the deadline, counting a budget from now (time_point::max() if none)
+     */
+    clock::time_point time() const noexcept
+    {
+        switch (m_kind)
+        {
+        case Kind::At:
+            return m_at;
+        case Kind::Budget:
+            return start().time();
+        default:
+            return clock::time_point::max();
+        }
+    }
+
+    /**
+     * \brief Checks whether the deadline has passed
+     */
+    bool expired() const noexcept
+    {
+        return is_set() && clock::now() >= time();
+    }
+
+private:
+    enum class Kind
+    {
+        None,
+        Budget,
+        At
+    };
+
+    template<typename Rep, typename Period>
+    void set_budget(std::chrono::duration<Rep, Period> budget) noexcept
+    {
+        // Budgets beyond the clock's range never expire
+        if (budget < std::chrono::duration_cast<std::chrono::duration<Rep, Period>>(clock::duration::max()))
+        {
+            m_kind = Kind::Budget;
+            m_budget = std::chrono::ceil<clock::duration>(budget);
+        }
+    }
+
+    Kind m_kind = Kind::None;
+    clock::duration m_budget{};
+    clock::time_point m_at{};
+};
+
+namespace aux
+{
+// How long a waiting pool thread sleeps before looking for queued jobs again
+constexpr std::chrono::microseconds help_interval{200};
+
+/**
+ * \brief Waits on a condition variable until a condition holds or the deadline passes
+ * 
+ * A pool thread must not simply block, since it may wait on work queued behind it. Without a
+ * deadline it runs queued jobs while waiting, looking for jobs queued later by other threads
+ * every help_interval. With one it cannot, as a job it picks may run past the deadline, so it
+ * blocks and a spare thread runs queued jobs in its stead (see ThreadPool::Blocking).
+ * 
+ * \param cv Condition variable notified when the condition may have changed
+ * \param lock Held lock guarding the condition
+ * \param deadline Time limit, already started
+ * \param pred Condition, checked under the lock
+ * \return bool False if the deadline passed first
+ */
+template<typename Pred>
+bool wait_helping(std::condition_variable& cv, std::unique_lock<std::mutex>& lock, const Deadline& deadline, Pred pred)
+{
+    auto* pool = ThreadPool::current();
+    if (deadline.is_set())
+    {
+        if (pred() || std::chrono::steady_clock::now() >= deadline.time())
+        {
+            return pred();
+        }
+        ThreadPool::Blocking blocking;
+        return cv.wait_until(lock, deadline.time(), pred);
+    }
+    if (!pool)
+    {
+        cv.wait(lock, pred);
+        return true;
+    }
+
+    while (!pred())
+    {
+        lock.unlock();
+        const bool ran = pool->run_pending();
+        lock.lock();
+        if (!ran)
+        {
+            cv.wait_for(lock, help_interval, pred);
+        }
+    }
+    return true;
+}
+
+/**
+ * \brief Blocks until a future is ready or the deadline passes, keeping the pool going like wait_helping
+ * 
+ * \tparam FutureType Type of the future, std::shared_future or Future
+ * \param fut Future to wait for
+ * \param deadline Time limit, already started
+ * \return std::future_status Ready, or timeout if the deadline passed first
+ */
+template<typename FutureType>
+std::future_status wait(const FutureType& fut, const Deadline& deadline = Deadline())
+{
+    auto* pool = ThreadPool::current();
+    if (deadline.is_set())
+    {
+        const auto status = fut.wait_for(std::chrono::seconds(0));
+        if (status == std::future_status::ready || std::chrono::steady_clock::now() >= deadline.time())
+        {
+            return status;
+        }
+        ThreadPool::Blocking blocking;
+        return fut.wait_until(deadline.time());
+    }
+    if (!pool)
+    {
+        fut.wait();
+        return std::future_status::ready;
+    }
+
+    while (fut.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    {
+        if (!pool->run_pending())
+        {
+            fut.wait_for(help_interval);
+        }
+    }
+    return std::future_status::ready;
+}
+} // namespace aux
+
+/**
+ * \brief Read-only view of a stop request, a C++17 counterpart of std::stop_token
+ */
+class StopToken
+{
+public:
+    /**
+     * \brief Constructs a token that is never stopped
+     */
+    StopToken() = default;
+
+    /**
+     * \brief Whether stop has been requested on the associated StopSource
+     */
+    bool stop_requested() const noexcept
+    {
+        return m_state && m_state->stopped.load(std::memory_order_acquire);
+    }
+
+    /**
+     * \brief Whether the token is associated with a StopSource at all
+     */
+    bool stop_possible() const noexcept
+    {
+        return m_state != nullptr;
+    }
+
+    /**
+     * \brief Deadline of the execution the token belongs to, so tasks can budget their work
+     */
+    Deadline deadline() const noexcept
+    {
+        return m_state ? m_state->deadline : Deadline();
+    }
+
+private:
+    friend class StopSource;
+
+    struct State
+    {
+        explicit State(const Deadline& until) : deadline(until)
+        {
+        }
+
+        std::atomic<bool> stopped{false};
+        const Deadline deadline;
+    };
+
+    explicit StopToken(std::shared_ptr<const State> state) : m_state(std::move(state))
+    {
+    }
+
+    std::shared_ptr<const State> m_state;
+};
+
+/**
+ * \brief Issues stop requests to every StopToken obtained from it, a C++17 counterpart of std::stop_source
+ */
+class StopSource
+{
+public:
+    StopSource() : StopSource(Deadline())
+    {
+    }
+
+    /**
+     * \brief Constructs a source whose tokens report the deadline of their execution
+     * 
+     * \param deadline Time limit, a budget starts counting now
+     */
+    explicit StopSource(const Deadline& deadline) : m_state(aux::make_pooled<StopToken::State>(deadline.start()))
+    {
+    }
+
+    /**
+     * \brief Token observing this source
+     */
+    StopToken get_token() const
+    {
+        return StopToken(m_state);
+    }
+
+    /**
+     * \brief Requests stop
+     * 
+     * \return bool True if this call made the request
+     */
+    bool request_stop() noexcept
+    {
+        return !m_state->stopped.exchange(true, std::memory_order_acq_rel);
+    }
+
+    bool stop_requested() const noexcept
+    {
+        return m_state->stopped.load(std::memory_order_acquire);
+    }
+
+    /**
+     * \brief Deadline reported to the tokens
+     */
+    const Deadline& deadline() const noexcept
+    {
+        return m_state->deadline;
+    }
+
+private:
+    std::shared_ptr<StopToken::State> m_state;
+};
+
+/**
+ * \brief Reported for tasks skipped because stop was requested before they started
+ */
+class TaskCancelled : public std::runtime_error
+{
+public:
+    TaskCancelled() : std::runtime_error("hypara: task cancelled before it started")
+    {
+    }
+};
+
+/**
+ * \brief Reported for tasks that did not finish before the deadline of their execution
+ */
+class TaskTimedOut : public std::runtime_error
+{
+public:
+    TaskTimedOut() : std::runtime_error("hypara: task did not finish before the deadline")
+    {
+    }
+};
+
+namespace aux
+{
+/**
+ * \brief Requests stop on a source when leaving scope
+ */
+class ScopedStop
+{
+public:
+    explicit ScopedStop(StopSource& source) : m_source(source)
+    {
+    }
+
+    ~ScopedStop()
+    {
+        m_source.request_stop();
+    }
+
+    ScopedStop(const ScopedStop&) = delete;
+    ScopedStop& operator=(const ScopedStop&) = delete;
+
+private:
+    StopSource& m_source;
+};
+} // namespace aux
+
+/**
+ * \brief Outcome of a task: either a value or the exception it threw
+ * 
+ * \tparam T Value type
+ */
+template<typename T>
+class Expected
+{
+public:
+    using value_type = T;
+
+    /**
+     * \brief Constructs a successful outcome
+     * 
+     * \param value Produced value
+     */
+    Expected(T value) : m_value(std::move(value))
+    {
+    }
+
+    /**
+     * \brief Constructs a failed outcome
+     * 
+     * \param error Exception thrown while producing the value
+     */
+    explicit Expected(std::exception_ptr error) : m_error(std::move(error))
+    {
+    }
+
+    bool has_value() const noexcept
+    {
+        return m_value.has_value();
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return has_value();
+    }
+
+    /**
+     * \brief Accesses the value, rethrowing the stored exception on failure
+     */
+    T& value() &
+    {
+        check();
+        return *m_value;
+    }
+
+    const T& value() const&
+    {
+        check();
+        return *m_value;
+    }
+
+    T&& value() &&
+    {
+        check();
+        return std::move(*m_value);
+    }
+
+    T& operator*() & noexcept
+    {
+        return *m_value;
+    }
+
+    const T& operator*() const& noexcept
+    {
+        return *m_value;
+    }
+
+    T&& operator*() && noexcept
+    {
+        return std::move(*m_value);
+    }
+
+    /**
+     * \brief Stored exception, or nullptr on success
+     */
+    std::exception_ptr error() const noexcept
+    {
+        return m_error;
+    }
+
+private:
+    void check() const
+    {
+        if (!m_value)
+        {
+            std::rethrow_exception(m_error);
+        }
+    }
+
+    std::optional<T> m_value;
+    std::exception_ptr m_error;
+};
+
+/**
+ * \brief Status of one function in a partial execution
+ */
+enum class OutcomeStatus
+{
+    Value,    // Finished in time with a value
+    TimedOut, // Still running at the deadline
+    Threw     // Threw an exception
+};
+
+/**
+ * \brief Outcome of one function in a partial execution: a value, a timeout or an exception
+ * 
+ * A timed out outcome holds a TaskTimedOut exception, so value() throws for both failures.
+ * 
+ * \tparam T Value type
+ */
+template<typename T>
+class Outcome : public Expected<T>
+{
+public:
+    Outcome(Expected<T> expected)
+        : Expected<T>(std::move(expected)), m_status(this->has_value() ? OutcomeStatus::Value : OutcomeStatus::Threw)
+    {
+    }
+
+    /**
+     * \brief Outcome of a function that missed the deadline
+     */
+    static Outcome timed_out()
+    {
+        Outcome outcome(Expected<T>(std::make_exception_ptr(TaskTimedOut())));
+        outcome.m_status = OutcomeStatus::TimedOut;
+        return outcome;
+    }
+
+    OutcomeStatus status() const noexcept
+    {
+        return m_status;
+    }
+
+private:
+    OutcomeStatus m_status;
+};
+
+namespace aux
+{
+/**
+ * \brief Immutable arguments shared by every task of an execution
+ * 
+ * Built once per execution by moving the caller's arguments in. Tasks read them in place, so
+ * large arguments are not copied per task and move-only ones can be passed by const reference.
+ * 
+ * \tparam Values Decayed argument types
+ */
+template<typename... Values>
+class ArgPack
+{
+public:
+    using tuple_type = std::tuple<Values...>;
+
+    template<typename... Args>
+    explicit ArgPack(std::in_place_t, Args&&...args)
+        : m_values(make_pooled<tuple_type>(std::forward<Args>(args)...))
+    {
+    }
+
+    /**
+     * \brief Wraps values owned elsewhere, e.g. by a pointer whose deleter reports that the tasks let go
+     */
+    explicit ArgPack(std::shared_ptr<const tuple_type> values) noexcept : m_values(std::move(values))
+    {
+    }
+
+    const tuple_type& values() const noexcept
+    {
+        return *m_values;
+    }
+
+private:
+    std::shared_ptr<const tuple_type> m_values;
+};
+
+/**
+ * \brief Packs arguments for the tasks of one execution
+ */
+template<typename... Args>
+ArgPack<std::decay_t<Args>...> make_args(Args&&...args)
+{
+    return ArgPack<std::decay_t<Args>...>(std::in_place, std::forward<Args>(args)...);
+}
+
+// A pack passed on to a combinator is shared, not packed again
+template<typename... Values>
+ArgPack<Values...> make_args(const ArgPack<Values...>& pack)
+{
+    return pack;
+}
+
+template<typename... Values>
+ArgPack<Values...> make_args(ArgPack<Values...>& pack)
+{
+    return pack;
+}
+
+template<typename... Values>
+ArgPack<Values...> make_args(ArgPack<Values...>&& pack)
+{
+    return std::move(pack);
+}
+
+/**
+ * \brief Parameter type through which a Worker passes an argument declared as T to its functions
+ * 
+ * Every function reads the execution's single copy, so by-value and rvalue reference arguments
+ * are passed by const reference; lvalue references are kept.
+ */
+template<typename T>
+using param_t = std::conditional_t<std::is_lvalue_reference_v<T>, T, const std::decay_t<T>&>;
+
+/**
+ * \brief Type in which a Worker execution keeps an argument declared as T
+ * 
+ * A copy, except for a reference to a type that cannot be copied, which is borrowed.
+ */
+template<typename T>
+using stored_arg_t = std::conditional_t<std::is_lvalue_reference_v<T> && !std::is_copy_constructible_v<std::decay_t<T>>,
+                                        T,
+                                        std::decay_t<T>>;
+
+/**
+ * \brief Invokes a callable, capturing its result or exception
+ * 
+ * \return Expected<result_type> Outcome of the call
+ */
+template<typename Fn, typename... Args>
+auto invoke_expected(Fn& fn, Args&&...args) -> Expected<std::invoke_result_t<Fn&, Args...>>
+{
+    using result_type = std::invoke_result_t<Fn&, Args...>;
+    try
+    {
+        return Expected<result_type>(std::invoke(fn, std::forward<Args>(args)...));
+    }
+    catch (...)
+    {
+        return Expected<result_type>(std::current_exception());
+    }
+}
+
+template<typename T>
+struct is_expected : std::false_type
+{
+};
+
+template<typename T>
+struct is_expected<Expected<T>> : std::true_type
+{
+};
+
+// Declared only, to read the parameter type of a unary callable in unevaluated contexts
+template<typename R, typename A>
+A param_of(R (*)(A));
+template<typename R, typename C, typename A>
+A param_of(R (C::*)(A));
+template<typename R, typename C, typename A>
+A param_of(R (C::*)(A) const);
+template<typename R, typename C, typename A>
+A param_of(R (C::*)(A) noexcept);
+template<typename R, typename C, typename A>
+A param_of(R (C::*)(A) const noexcept);
+
+template<typename Func, typename = void>
+struct takes_expected : std::false_type
+{
+};
+
+template<typename Func>
+struct takes_expected<Func, std::enable_if_t<std::is_function_v<std::remove_pointer_t<Func>>>>
+    : is_expected<std::decay_t<decltype(param_of(std::declval<std::decay_t<Func>>()))>>
+{
+};
+
+template<typename Func>
+struct takes_expected<Func, std::void_t<decltype(param_of(&Func::operator()))>>
+    : is_expected<std::decay_t<decltype(param_of(&Func::operator()))>>
+{
+};
+
+/**
+ * \brief Whether a continuation declares an Expected parameter, and so also receives exceptions
+ * 
+ * Generic callables receive the value.
+ */
+template<typename Func>
+inline constexpr bool takes_expected_v = takes_expected<std::decay_t<Func>>::value;
+
+template<typename Func, typename Ret>
+using then_result =
+    std::conditional_t<takes_expected_v<Func>, std::invoke_result<Func&, Expected<Ret>>, std::invoke_result<Func&, Ret>>;
+
+/**
+ * \brief Whether a continuation can be called through a const reference, so it keeps no state between calls
+ */
+template<typename Func, typename Ret>
+inline constexpr bool then_is_const_v = std::conditional_t<takes_expected_v<Func>,
+                                                           std::is_invocable<const std::decay_t<Func>&, Expected<Ret>>,
+                                                           std::is_invocable<const std::decay_t<Func>&, Ret>>::value;
+
+/**
+ * \brief Whether a task callable can be called through a const reference, with or without a StopToken
+ * 
+ * Callables that cannot, such as mutable lambdas, may change their state when called.
+ */
+template<typename Fn, typename... Args>
+inline constexpr bool is_const_callable_v =
+    std::is_invocable_v<const Fn&, const StopToken&, Args...> || std::is_invocable_v<const Fn&, Args...>;
+
+struct TaskAccess;
+} // namespace aux
+
+/**
+ * \brief Represents an asynchronous task that can be executed with specified arguments.
+ * 
+ * \tparam T Function signature type (e.g., int(double, float))
+ */
+template<typename T>
+class Task;
+
+/**
+ * \brief Specialization of Task for function signatures.
+ * 
+ * Runs and copies of a task share its callable when it can be called through a const reference,
+ * so such a callable may run concurrently. Any other callable, e.g. a mutable lambda, is copied for
+ * each run like a std::packaged_task would, so every run starts from its initial state.
+ * 
+ * \tparam Ret Return type of the task
+ * \tparam Args Argument types that the task accepts
+ */
+template<typename Ret, typename... Args>
+class Task<Ret(Args...)>
+{
+public:
+    using return_type = Ret;
+    using function_type = std::function<Ret(const StopToken&, Args...)>;
+
+    /**
+     * \brief Constructs a Task from a callable object
+     * 
+     * The callable may take a StopToken as its first parameter to observe cancellation.
+     * 
+     * \tparam Fn Type of the callable object
+     * \param fn Callable object to be wrapped
+     */
+    template<typename Fn, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Fn>, Task>>>
+    explicit Task(Fn&& fn)
+        : m_fn(std::make_shared<const function_type>(adapt(std::forward<Fn>(fn)))),
+          m_stateful(!aux::is_const_callable_v<std::decay_t<Fn>, Args...>)
+    {
+    }
+
+    /**
+     * \brief Constructs a Task from a callable object, bound to a specific pool
+     * 
+     * \tparam Fn Type of the callable object
+     * \param fn Callable object to be wrapped
+     * \param pool Pool the task is executed on
+     */
+    template<typename Fn>
+    Task(Fn&& fn, ThreadPool& pool)
+        : m_fn(std::make_shared<const function_type>(adapt(std::forward<Fn>(fn)))), m_pool(&pool),
+          m_stateful(!aux::is_const_callable_v<std::decay_t<Fn>, Args...>)
+    {
+    }
+
+    /**
+     * \brief Executes the task asynchronously
+     * 
+     * \param args Arguments to pass to the task
+     * \return std::shared_future<Ret> Shared future representing the task result
+     */
+    std::shared_future<Ret> run(Args... args) const
+    {
+        return run(StopToken(), std::forward<Args>(args)...);
+    }
+
+    /**
+     * \brief Executes the task asynchronously, skipping it if stop is requested before it starts
+     * 
+     * \param token Token observed by the task
+     * \param args Arguments to pass to the task
+     * \return std::shared_future<Ret> Shared future representing the task result (TaskCancelled if skipped)
+     */
+    std::shared_future<Ret> run(const StopToken& token, Args... args) const
+    {
+        auto promise = std::make_shared<std::promise<Ret>>();
+        auto fut = promise->get_future().share();
+
+        dispatch(
+            [fn = callable(),
+             promise,
+             token,
+             pool = &pool(),
+             values = values_type(std::forward<Args>(args)...)]() mutable
+            {
+                try
+                {
+                    if (token.stop_requested())
+                    {
+                        pool->note_cancelled();
+                        throw TaskCancelled();
+                    }
+
+                    if constexpr (std::is_void_v<Ret>)
+                    {
+                        call(*fn, token, values);
+                        promise->set_value();
+                    }
+                    else
+                    {
+                        promise->set_value(call(*fn, token, values));
+                    }
+                }
+                catch (...)
+                {
+                    promise->set_exception(std::current_exception());
+                }
+            });
+
+        return fut;
+    }
+
+    /**
+     * \brief Executes the task asynchronously, returning a lightweight future
+     * 
+     * Same as run(), but the future and the pool job share one allocation. Combinators use it.
+     * 
+     * \param token Token observed by the task
+     * \param args Arguments to pass to the task
+     * \return aux::Future<Ret> Future representing the task result (TaskCancelled if skipped)
+     */
+    aux::Future<Ret> spawn(const StopToken& token, Args... args) const
+    {
+        return launch([fn = callable(), token, values = values_type(std::forward<Args>(args)...)]() mutable -> Ret
+                      { return call(*fn, token, values); },
+                      token);
+    }
+
+    /**
+     * \brief Executes the task asynchronously on arguments shared with other tasks, see spawn()
+     * 
+     * \param token Token observed by the task
+     * \param pack Arguments, passed by const reference where the task takes them so
+     * \return aux::Future<Ret> Future representing the task result (TaskCancelled if skipped)
+     */
+    template<typename... Values>
+    aux::Future<Ret> spawn(const StopToken& token, const aux::ArgPack<Values...>& pack) const
+    {
+        return launch([fn = callable(), token, pack]() -> Ret { return apply(*fn, token, pack); }, token);
+    }
+
+    /**
+     * \brief Executes the task asynchronously and hands its outcome to a callback
+     * 
+     * \tparam Callback Type of the callback, invoked as callback(Expected<Ret>&&)
+     * \param callback Callback run on the completing thread, must not throw
+     * \param args Arguments to pass to the task
+     */
+    template<typename Callback>
+    void post(Callback&& callback, Args... args) const
+    {
+        post(std::forward<Callback>(callback), StopToken(), std::forward<Args>(args)...);
+    }
+
+    /**
+     * \brief Executes the task asynchronously and hands its outcome to a callback
+     * 
+     * If stop is requested before the task starts, it is skipped and the callback receives TaskCancelled.
+     * 
+     * \tparam Callback Type of the callback, invoked as callback(Expected<Ret>&&)
+     * \param callback Callback run on the completing thread, must not throw
+     * \param token Token observed by the task
+     * \param args Arguments to pass to the task
+     */
+    template<typename Callback>
+    void post(Callback&& callback, const StopToken& token, Args... args) const
+    {
+        dispatch(
+            [fn = callable(),
+             callback = std::forward<Callback>(callback),
+             token,
+             pool = &pool(),
+             values = values_type(std::forward<Args>(args)...)]() mutable
+            {
+                if (token.stop_requested())
+                {
+                    pool->note_cancelled();
+                    callback(Expected<Ret>(std::make_exception_ptr(TaskCancelled())));
+                    return;
+                }
+                auto run_once = [&]() -> Ret { return call(*fn, token, values); };
+                callback(aux::invoke_expected(run_once));
+            });
+    }
+
+    /**
+     * \brief Executes the task asynchronously on arguments shared with other tasks, see post()
+     * 
+     * \tparam Callback Type of the callback, invoked as callback(Expected<Ret>&&)
+     * \param callback Callback run on the completing thread, must not throw
+     * \param token Token observed by the task
+     * \param pack Arguments, passed by const reference where the task takes them so
+     */
+    template<typename Callback, typename... Values>
+    void post(Callback&& callback, const StopToken& token, const aux::ArgPack<Values...>& pack) const
+    {
+        dispatch(
+            [fn = callable(), callback = std::forward<Callback>(callback), token, pool = &pool(), pack]() mutable
+            {
+                if (token.stop_requested())
+                {
+                    pool->note_cancelled();
+                    callback(Expected<Ret>(std::make_exception_ptr(TaskCancelled())));
+                    return;
+                }
+                auto run_once = [&]() { return apply(*fn, token, pack); };
+                callback(aux::invoke_expected(run_once));
+            });
+    }
+
+    /**
+     * \brief Blocks until the task completes
+     * 
+     * \param args Arguments to pass to the task
+     */
+    void wait(Args... args) const
+    {
+        run(std::forward<Args>(args)...).wait();
+    }
+
+    /**
+     * \brief Executes the task on the calling thread and returns the result
+     * 
+     * \param args Arguments to pass to the task
+     * \return Ret Result of the task
+     */
+    Ret get(Args... args) const
+    {
+        return (*callable())(StopToken(), std::forward<Args>(args)...);
+    }
+
+    /**
+     * \brief Chains another task to be executed after this one
+     * 
+     * The continuation runs on the thread that completed this task, right after it, so a chain
+     * occupies a single thread and no thread waits on another. A continuation taking the value is
+     * skipped when this task throws; one taking an Expected<Ret> also receives the exception.
+     * 
+     * \tparam Func Type of the continuation function
+     * \param fn Continuation function, invoked with Ret or Expected<Ret>
+     * \return Task<NewRet(Args...)> New task representing the continuation
+     */
+    template<typename Func>
+    auto then(Func&& fn) const -> Task<typename aux::then_result<std::decay_t<Func>, Ret>::type(Args...)>
+    {
+        using result_type = typename aux::then_result<std::decay_t<Func>, Ret>::type;
+        // Holds its own copy of the first callable, so copying the chain for a run copies both
+        Task<result_type(Args...)> chain(
+            [first = *m_fn, fn = std::forward<Func>(fn)](const StopToken& token, Args... args) mutable
+            {
+                if constexpr (aux::takes_expected_v<Func>)
+                {
+                    return fn(aux::invoke_expected(first, token, std::forward<Args>(args)...));
+                }
+                else
+                {
+                    return fn(first(token, std::forward<Args>(args)...));
+                }
+            },
+            pool());
+        chain.m_stateful = m_stateful || !aux::then_is_const_v<Func, Ret>;
+        return chain;
+    }
+
+    /**
+     * \brief Pool the task is executed on
+     * 
+     * \return ThreadPool& Bound pool, or the global pool if the task is unbound
+     */
+    ThreadPool& pool() const
+    {
+        return m_pool ? *m_pool : ThreadPool::global();
+    }
+
+    /**
+     * \brief Copy of the task, sharing its function, that runs on the calling thread instead of the pool
+     * 
+     * Meant for functions cheaper than a trip through the pool. run() and post() then complete
+     * before returning, and combinators run inline tasks after dispatching the others.
+     * 
+     * \param runs_inline Whether the copy runs inline
+     * \return Task Copy of the task
+     */
+    Task inlined(bool runs_inline = true) const
+    {
+        Task task(*this);
+        task.m_inline = runs_inline;
+        return task;
+    }
+
+    bool is_inline() const noexcept
+    {
+        return m_inline;
+    }
+
+private:
+    template<typename>
+    friend class Task;
+
+    template<typename, typename...>
+    friend class TaskAwaiter;
+
+    friend struct aux::TaskAccess;
+
+    // Starts a combinator's tasks directly, handing its outcome to the callback once they decided
+    using start_type = std::function<void(std::function<void(Expected<Ret>&&)>)>;
+
+    /**
+     * \brief Callable for one run: the shared one, or a fresh copy of a stateful one
+     */
+    std::shared_ptr<const function_type> callable() const
+    {
+        return m_stateful ? std::make_shared<const function_type>(*m_fn) : m_fn;
+    }
+
+    // Arguments stored for a single run
+    using values_type = std::tuple<std::decay_t<Args>...>;
+
+    /**
+     * \brief Calls the function on arguments stored for a single run, moving those taken by value
+     */
+    static Ret call(const function_type& fn, const StopToken& token, values_type& values)
+    {
+        return std::apply([&](std::decay_t<Args>&...args) -> Ret { return fn(token, std::forward<Args>(args)...); },
+                          values);
+    }
+
+    // Like post(), on arguments the caller keeps alive until the callback runs
+    template<typename Callback>
+    void post_borrowed(Callback&& callback, const StopToken& token, values_type& values) const
+    {
+        if constexpr (sizeof...(Args) == 0)
+        {
+            if (m_start)
+            {
+                start(std::forward<Callback>(callback), token);
+                return;
+            }
+        }
+        dispatch(
+            [fn = callable(), callback = std::forward<Callback>(callback), token, pool = &pool(), &values]() mutable
+            {
+                if (token.stop_requested())
+                {
+                    pool->note_cancelled();
+                    callback(Expected<Ret>(std::make_exception_ptr(TaskCancelled())));
+                    return;
+                }
+                auto run_once = [&]() -> Ret { return call(*fn, token, values); };
+                callback(aux::invoke_expected(run_once));
+            });
+    }
+
+    // Like post(), through the start hook, so no thread waits for the tasks of the combinator
+    template<typename Callback>
+    void start(Callback&& callback, const StopToken& token) const
+    {
+        if (token.stop_requested())
+        {
+            pool().note_cancelled();
+            callback(Expected<Ret>(std::make_exception_ptr(TaskCancelled())));
+            return;
+        }
+        auto shared = std::make_shared<std::decay_t<Callback>>(std::forward<Callback>(callback));
+        (*m_start)([shared](Expected<Ret>&& outcome) { (*shared)(std::move(outcome)); });
+    }
+
+    template<typename Call>
+    aux::Future<Ret> launch(Call&& call, const StopToken& token) const
+    {
+        auto job = [call = std::forward<Call>(call), token, pool = &pool()]() mutable -> Ret
+        {
+            if (token.stop_requested())
+            {
+                pool->note_cancelled();
+                throw TaskCancelled();
+            }
+            return call();
+        };
+        auto* state = new aux::TaskState<Ret, decltype(job)>(std::move(job));
+        aux::Future<Ret> fut(state);
+
+        if (m_inline)
+        {
+            state->run();
+        }
+        else
+        {
+            pool().submit(static_cast<aux::Job*>(state));
+        }
+        return fut;
+    }
+
+    template<typename... Values>
+    static Ret apply(const function_type& fn, const StopToken& token, const aux::ArgPack<Values...>& pack)
+    {
+        if constexpr (std::is_invocable_v<const function_type&, const StopToken&, const Values&...>)
+        {
+            return std::apply([&](const Values&...values) -> Ret { return fn(token, values...); }, pack.values());
+        }
+        else
+        {
+            // Parameters taken by non-const reference get a private copy of the arguments
+            static_assert(std::is_copy_constructible_v<std::tuple<Values...>>,
+                          "move-only arguments must be taken by const reference");
+            auto values = pack.values();
+            return std::apply([&](Values&...copies) -> Ret { return fn(token, copies...); }, values);
+        }
+    }
+
+    template<typename Job>
+    void dispatch(Job&& job) const
+    {
+        if (m_inline)
+        {
+            job();
+        }
+        else
+        {
+            pool().submit(std::forward<Job>(job));
+        }
+    }
+
+    template<typename Fn>
+    static function_type adapt(Fn&& fn)
+    {
+        if constexpr (std::is_invocable_r_v<Ret, std::decay_t<Fn>&, const StopToken&, Args...>)
+        {
+            return function_type(std::forward<Fn>(fn));
+        }
+        else
+        {
+            return function_type([fn = std::forward<Fn>(fn)](const StopToken&, Args... args) mutable -> Ret
+                                 { return fn(std::forward<Args>(args)...); });
+        }
+    }
+
+    // Shared, so copying a Task or running it only copies the callable if it is stateful
+    std::shared_ptr<const function_type> m_fn;
+    std::shared_ptr<const start_type> m_start;
+    ThreadPool* m_pool = nullptr;
+    bool m_stateful = false;
+    bool m_inline = false;
+};
+
+namespace aux
+{
+/**
+ * \brief Lets combinators attach a start hook to the task they return
+ */
+struct TaskAccess
+{
+    template<typename Ret, typename Start>
+    static Task<Ret()> with_start(Task<Ret()> task, Start&& start)
+    {
+        using start_type = typename Task<Ret()>::start_type;
+        task.m_start = std::make_shared<const start_type>(std::forward<Start>(start));
+        return task;
+    }
+};
+
+/**
+ * \brief Type trait to extract the result type from futures
+ * 
+ * \tparam T Type to extract result from
+ */
+template<typename T>
+struct range_trait
+{
+    using type = T;
+};
+
+/**
+ * \brief Specialization for std::shared_future
+ * 
+ * \tparam Ret Result type of the future
+ */
+template<typename Ret>
+struct range_trait<std::shared_future<Ret>>
+{
+    using type = Ret;
+};
+
+template<typename Ret>
+struct range_trait<Future<Ret>>
+{
+    using type = Ret;
+};
+
+template<typename T>
+using range_trait_t = typename range_trait<T>::type;
+
+/**
+ * \brief Selects the pool a combinator over a range of tasks runs on
+ * 
+ * \tparam Range Type of the task range
+ * \param range Container of tasks
+ * \return ThreadPool& Pool of the first task, or the global pool for an empty range
+ */
+template<typename Range>
+ThreadPool& pool_of(const Range& range)
+{
+    return range.empty() ? ThreadPool::global() : std::begin(range)->pool();
+}
+
+/**
+ * \brief Immutable task range sharing its tasks between copies
+ * 
+ * Combinators capture their range by value; capturing a TaskList only bumps a reference count.
+ * 
+ * \tparam TaskType Type of the tasks
+ */
+template<typename TaskType>
+class TaskList
+{
+public:
+    using value_type = TaskType;
+    using const_iterator = typename std::vector<TaskType>::const_iterator;
+
+    TaskList() = default;
+
+    explicit TaskList(std::shared_ptr<const std::vector<TaskType>> tasks) : m_tasks(std::move(tasks))
+    {
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return m_tasks ? m_tasks->begin() : const_iterator();
+    }
+
+    const_iterator end() const noexcept
+    {
+        return m_tasks ? m_tasks->end() : const_iterator();
+    }
+
+    size_t size() const noexcept
+    {
+        return m_tasks ? m_tasks->size() : 0;
+    }
+
+    bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    const TaskType& operator[](size_t index) const
+    {
+        return (*m_tasks)[index];
+    }
+
+private:
+    std::shared_ptr<const std::vector<TaskType>> m_tasks;
+};
+
+/**
+ * \brief Transforms a range of tasks into a vector of futures
+ * 
+ * \tparam Range Type of the task range
+ * \tparam Args Argument types for the tasks
+ * \param range Container of tasks
+ * \param pack Arguments shared by the tasks
+ * \param token Token observed by the tasks
+ * \return std::vector<Future<result_type>> Vector of futures
+ */
+template<typename Range, typename... Args>
+auto transform(const Range& range, const ArgPack<Args...>& pack, const StopToken& token = StopToken())
+    -> std::vector<Future<typename Range::value_type::return_type>>
+{
+    using result_type = typename Range::value_type::return_type;
+    std::vector<Future<result_type>> funcs(range.size());
+
+    // Dispatch to the pool first, so inline tasks run here while the others proceed
+    for (bool runsInline : {false, true})
+    {
+        size_t index = 0;
+        for (const auto& task : range)
+        {
+            if (task.is_inline() == runsInline)
+            {
+                funcs[index] = task.spawn(token, pack);
+            }
+            ++index;
+        }
+    }
+    return funcs;
+}
+
+/**
+ * \brief Index of the calling thread's shard in sharded state
+ */
+inline size_t thread_shard() noexcept
+{
+    static std::atomic<size_t> next{0};
+    static thread_local const size_t shard = next.fetch_add(1, std::memory_order_relaxed);
+    return shard;
+}
+
+/**
+ * \brief Predicate accepting every result
+ */
+struct AcceptAll
+{
+    template<typename T>
+    bool operator()(const T&) const noexcept
+    {
+        return true;
+    }
+};
+
+/**
+ * \brief Runs callbacks at given times on a single background thread
+ * 
+ * Callbacks should only hand work over, such as submitting a job, so they never delay each other.
+ */
+class TimerQueue
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    static TimerQueue& instance()
+    {
+        // Leaked along with its detached thread, so timers may still fire during static destruction
+        static TimerQueue* queue = new TimerQueue();
+        return *queue;
+    }
+
+    /**
+     * \brief Schedules a callback
+     * 
+     * \param time Time to run the callback at, a past time runs it right away
+     * \param fn Callback, must not throw
+     */
+    void at(clock::time_point time, std::function<void()> fn)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_timers.push_back(Timer{time, m_sequence++, std::move(fn)});
+            std::push_heap(m_timers.begin(), m_timers.end(), later);
+        }
+        m_cv.notify_one();
+    }
+
+private:
+    struct Timer
+    {
+        clock::time_point time;
+        uint64_t sequence;
+        std::function<void()> fn;
+    };
+
+    TimerQueue()
+    {
+        std::thread([this]() { loop(); }).detach();
+    }
+
+    static bool later(const Timer& a, const Timer& b) noexcept
+    {
+        return a.time != b.time ? a.time > b.time : a.sequence > b.sequence;
+    }
+
+    void loop()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true)
+        {
+            if (m_timers.empty())
+            {
+                m_cv.wait(lock);
+                continue;
+            }
+            const auto next = m_timers.front().time;
+            if (clock::now() < next)
+            {
+                m_cv.wait_until(lock, next);
+                continue;
+            }
+            std::pop_heap(m_timers.begin(), m_timers.end(), later);
+            auto fn = std::move(m_timers.back().fn);
+            m_timers.pop_back();
+            lock.unlock();
+            fn();
+            lock.lock();
+        }
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::vector<Timer> m_timers;
+    uint64_t m_sequence = 0;
+};
+
+/**
+ * \brief Completion state shared between the tasks of one combinator execution and its waiter
+ * 
+ * Tasks report from their own threads. Whoever closes the state first (a task deciding the
+ * outcome, or the waiter at the deadline) requests stop on the remaining tasks, and only a closing
+ * task wakes the waiter.
+ */
+class Completion
+{
+public:
+    Completion(size_t count, const Deadline& deadline) : m_remaining(count), m_stop(deadline)
+    {
+        if (count == 0)
+        {
+            m_closed.store(true);
+            m_done = true;
+        }
+    }
+
+    /**
+     * \brief Token the tasks should observe, stopped once the state is closed
+     */
+    StopToken token() const
+    {
+        return m_stop.get_token();
+    }
+
+    /**
+     * \brief Calls a continuation once the state is closed, instead of waking a waiter
+     * 
+     * Runs the continuation right away if the state is already done. Otherwise it runs on the closing
+     * task's thread, or on the pool once the deadline closes the state, so nothing waits meanwhile.
+     * 
+     * \param self Owner of this state, kept weakly until the deadline
+     * \param pool Pool to run the continuation on at the deadline
+     * \param continuation Continuation, must not throw
+     */
+    void continue_with(std::weak_ptr<Completion> self, ThreadPool& pool, std::function<void()> continuation)
+    {
+        // Scheduled first, so a failure to schedule leaves no continuation behind
+        const auto& deadline = m_stop.deadline();
+        if (deadline.is_set() && !closed())
+        {
+            TimerQueue::instance().at(deadline.time(),
+                                      [self = std::move(self), pool = &pool]()
+                                      {
+                                          auto state = self.lock();
+                                          if (state && state->try_close())
+                                          {
+                                              pool->submit([state]() { state->signal(); });
+                                          }
+                                      });
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_done)
+            {
+                m_continuation = std::move(continuation);
+                return;
+            }
+        }
+        continuation();
+    }
+
+protected:
+    /**
+     * \brief Waits until a task closes the state, or closes it at the deadline
+     * 
+     * \return bool False if the deadline closed the state
+     */
+    bool wait_closed()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        auto done = [this]() { return m_done; };
+        if (!aux::wait_helping(m_cv, lock, m_stop.deadline(), done) && try_close())
+        {
+            return false;
+        }
+        // Either already done or a task closed the state just before the deadline
+        aux::wait_helping(m_cv, lock, Deadline(), done);
+        return true;
+    }
+
+    /**
+     * \brief Closes the state and stops the remaining tasks
+     * 
+     * \return bool False if the state was already closed
+     */
+    bool try_close()
+    {
+        if (m_closed.exchange(true))
+        {
+            return false;
+        }
+        m_stop.request_stop();
+        return true;
+    }
+
+    bool closed() const noexcept
+    {
+        return m_closed.load();
+    }
+
+    /**
+     * \brief Counts one finished task
+     * 
+     * \return bool True for the last task
+     */
+    bool arrive()
+    {
+        return m_remaining.fetch_sub(1) == 1;
+    }
+
+    /**
+     * \brief Wakes the waiter, or runs the continuation, after the closing task published its outcome
+     */
+    void signal()
+    {
+        std::function<void()> continuation;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_done = true;
+            continuation = std::move(m_continuation);
+        }
+        if (continuation)
+        {
+            continuation();
+            return;
+        }
+        m_cv.notify_one();
+    }
+
+    /**
+     * \brief Waits until the state is closed, a condition holds or a time passes, without closing it
+     * 
+     * \param until Time to stop waiting at
+     * \param pred Condition, checked under the lock of the state
+     * \return bool False if the time passed
+     */
+    template<typename Pred>
+    bool wait_progress(std::chrono::steady_clock::time_point until, Pred pred)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return aux::wait_helping(m_cv, lock, Deadline(until), [&]() { return m_closed.load() || pred(); });
+    }
+
+    /**
+     * \brief Wakes the waiter to recheck the condition of wait_progress
+     */
+    void notify()
+    {
+        {
+            // Pairs with the condition check so the wakeup cannot be missed
+            std::lock_guard<std::mutex> lock(m_mutex);
+        }
+        m_cv.notify_one();
+    }
+
+private:
+    std::atomic<bool> m_closed{false};
+    std::atomic<size_t> m_remaining;
+    StopSource m_stop;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_done = false;
+    std::function<void()> m_continuation;
+};
+
+/**
+ * \brief Shared completion slot that a group of tasks race to fill
+ * 
+ * The first successful result passing the predicate closes the slot and becomes the winner;
+ * the last failure closes it without one.
+ * 
+ * \tparam Ret Result type of the tasks
+ * \tparam Pred Type of the predicate results must pass
+ */
+template<typename Ret, typename Pred = AcceptAll>
+class CompletionSlot : public Completion
+{
+public:
+    CompletionSlot(size_t count, Pred pred, const Deadline& deadline)
+        : Completion(count, deadline), m_pred(std::move(pred))
+    {
+    }
+
+    /**
+     * \brief Reports the outcome of one task, called from the completing thread
+     * 
+     * \param index Index of the task
+     * \param outcome Result or exception of the task
+     */
+    void complete(size_t index, Expected<Ret>&& outcome)
+    {
+        if (outcome && accepts(*outcome) && try_close())
+        {
+            m_winner = static_cast<int>(index);
+            m_value.emplace(std::move(*outcome));
+            signal();
+            return;
+        }
+
+        if (arrive() && try_close())
+        {
+            signal();
+        }
+    }
+
+    /**
+     * \brief Waits for a winner, all tasks failing, or the deadline
+     * 
+     * \return std::pair<int, std::optional<Ret>> Index and result of the winner (-1 if none)
+     */
+    std::pair<int, std::optional<Ret>> wait()
+    {
+        wait_closed();
+        return result();
+    }
+
+    /**
+     * \brief Takes the outcome once the slot is done, see continue_with()
+     * 
+     * \return std::pair<int, std::optional<Ret>> Index and result of the winner (-1 if none)
+     */
+    std::pair<int, std::optional<Ret>> result()
+    {
+        // Closing at the deadline leaves no winner
+        if (m_winner < 0)
+        {
+            return {-1, std::optional<Ret>()};
+        }
+        return {m_winner, std::move(m_value)};
+    }
+
+private:
+    bool accepts(const Ret& value)
+    {
+        try
+        {
+            return m_pred(value);
+        }
+        catch (...)
+        {
+            return false;
+        }
+    }
+
+    Pred m_pred;
+    int m_winner = -1;
+    std::optional<Ret> m_value;
+};
+
+/**
+ * \brief Completion slot collecting the result of every task
+ * 
+ * The first failure closes the slot without results; the last success closes it with all of them.
+ * 
+ * \tparam Ret Result type of the tasks
+ */
+template<typename Ret>
+class AllSlot : public Completion
+{
+public:
+    AllSlot(size_t count, const Deadline& deadline)
+        : Completion(count, deadline), m_values(count), m_complete(count == 0)
+    {
+    }
+
+    /**
+     * \brief Reports the outcome of one task, called from the completing thread
+     * 
+     * \param index Index of the task
+     * \param outcome Result or exception of the task
+     */
+    void complete(size_t index, Expected<Ret>&& outcome)
+    {
+        if (!outcome)
+        {
+            if (try_close())
+            {
+                signal();
+            }
+            return;
+        }
+
+        // Published to the closing task by the count of arrivals
+        m_values[index].emplace(std::move(*outcome));
+        if (arrive() && try_close())
+        {
+            m_complete = true;
+            signal();
+        }
+    }
+
+    /**
+     * \brief Waits for every result, a failure, or the deadline
+     * 
+     * \return std::optional<std::vector<Ret>> Results in task order (nullopt on failure)
+     */
+    std::optional<std::vector<Ret>> wait()
+    {
+        wait_closed();
+        return result();
+    }
+
+    /**
+     * \brief Takes the outcome once the slot is done, see continue_with()
+     * 
+     * \return std::optional<std::vector<Ret>> Results in task order (nullopt on failure)
+     */
+    std::optional<std::vector<Ret>> result()
+    {
+        if (!m_complete)
+        {
+            return std::nullopt;
+        }
+        std::vector<Ret> values;
+        values.reserve(m_values.size());
+        for (auto& value : m_values)
+        {
+            values.push_back(std::move(*value));
+        }
+        return values;
+    }
+
+private:
+    std::vector<std::optional<Ret>> m_values;
+    bool m_complete;
+};
+
+/**
+ * \brief Completion slot whose tasks are started one at a time by the waiter
+ * 
+ * The first successful result wins as in CompletionSlot; failures additionally wake the waiter,
+ * so the next task starts right away instead of after the hedging delay.
+ * 
+ * \tparam Ret Result type of the tasks
+ */
+template<typename Ret>
+class HedgedSlot : public CompletionSlot<Ret>
+{
+public:
+    HedgedSlot(size_t count, const Deadline& deadline) : CompletionSlot<Ret>(count, AcceptAll(), deadline)
+    {
+    }
+
+    void complete(size_t index, Expected<Ret>&& outcome)
+    {
+        const bool failed = !outcome;
+        CompletionSlot<Ret>::complete(index, std::move(outcome));
+        if (failed)
+        {
+            m_failures.fetch_add(1);
+            this->notify();
+        }
+    }
+
+    /**
+     * \brief Waits until another task should start: the delay passed or every started task failed
+     * 
+     * \param started Number of tasks started so far
+     * \param until End of the hedging delay
+     * \return bool False once a winner or the deadline closed the slot
+     */
+    bool wait_backup(size_t started, std::chrono::steady_clock::time_point until)
+    {
+        this->wait_progress(until, [&]() { return m_failures.load() >= started; });
+        return !this->closed();
+    }
+
+private:
+    std::atomic<size_t> m_failures{0};
+};
+
+/**
+ * \brief Completion state collecting the first results accepted by a predicate
+ * 
+ * The slot closes once it holds the quorum, or when the last task finished without reaching it.
+ * 
+ * \tparam Ret Result type of the tasks
+ * \tparam Pred Type of the predicate results must pass
+ */
+template<typename Ret, typename Pred = AcceptAll>
+class QuorumSlot : public Completion
+{
+public:
+    QuorumSlot(size_t count, size_t quorum, Pred pred, const Deadline& deadline)
+        : Completion(quorum == 0 ? 0 : count, deadline), m_quorum(quorum), m_pred(std::move(pred))
+    {
+        m_results.reserve(std::min(count, quorum));
+    }
+
+    /**
+     * \brief Reports the outcome of one task, called from the completing thread
+     * 
+     * \param index Index of the task
+     * \param outcome Result or exception of the task
+     */
+    void complete(size_t index, Expected<Ret>&& outcome)
+    {
+        if (outcome && accepts(*outcome))
+        {
+            bool reached = false;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_results.size() < m_quorum)
+                {
+                    m_results.emplace_back(static_cast<int>(index), std::move(*outcome));
+                    reached = m_results.size() == m_quorum;
+                }
+            }
+            if (reached && try_close())
+            {
+                signal();
+                return;
+            }
+        }
+
+        if (arrive() && try_close())
+        {
+            signal();
+        }
+    }
+
+    /**
+     * \brief Waits for the quorum, all tasks finishing, or the deadline
+     * 
+     * \return std::vector<std::pair<int, Ret>> Indices and results in arrival order, fewer than the quorum if it was missed
+     */
+    std::vector<std::pair<int, Ret>> wait()
+    {
+        wait_closed();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return std::exchange(m_results, {});
+    }
+
+private:
+    bool accepts(const Ret& value)
+    {
+        try
+        {
+            return m_pred(value);
+        }
+        catch (...)
+        {
+            return false;
+        }
+    }
+
+    const size_t m_quorum;
+    Pred m_pred;
+    std::mutex m_mutex;
+    std::vector<std::pair<int, Ret>> m_results;
+};
+
+/**
+ * \brief Queue of successful results in completion order, filled by the tasks of one execution
+ * 
+ * \tparam Ret Result type of the tasks
+ */
+template<typename Ret>
+class Channel
+{
+public:
+    Channel(size_t count, const Deadline& deadline) : m_remaining(count), m_stop(deadline)
+    {
+    }
+
+    StopToken token() const
+    {
+        return m_stop.get_token();
+    }
+
+    /**
+     * \brief Reports the outcome of one task, called from the completing thread
+     * 
+     * \param index Index of the task
+     * \param outcome Result or exception of the task, dropped on failure
+     */
+    void complete(size_t index, Expected<Ret>&& outcome)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (outcome)
+            {
+                m_ready.emplace(static_cast<int>(index), std::move(*outcome));
+            }
+            --m_remaining;
+        }
+        m_cv.notify_one();
+    }
+
+    /**
+     * \brief Waits for the next result
+     * 
+     * Past the deadline the remaining tasks are stopped and only results already queued are returned.
+     * 
+     * \return std::optional<std::pair<int, Ret>> Index and result, nullopt once there are no more
+     */
+    std::optional<std::pair<int, Ret>> pop()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        auto ready = [this]() { return !m_ready.empty() || m_remaining == 0; };
+        if (!aux::wait_helping(m_cv, lock, m_stop.deadline(), ready))
+        {
+            m_stop.request_stop();
+            return std::nullopt;
+        }
+
+        if (m_ready.empty())
+        {
+            return std::nullopt;
+        }
+        auto item = std::move(m_ready.front());
+        m_ready.pop();
+        return item;
+    }
+
+    /**
+     * \brief Stops the tasks that did not start yet
+     */
+    void close() noexcept
+    {
+        m_stop.request_stop();
+    }
+
+private:
+    size_t m_remaining;
+    StopSource m_stop;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::queue<std::pair<int, Ret>> m_ready;
+};
+
+/**
+ * \brief Completion state folding results with an associative operation as they arrive
+ * 
+ * Results are folded into per-thread partial accumulators, which are combined once every task
+ * succeeded. Any failing task closes the state early, as does the deadline.
+ * 
+ * \tparam Ret Result type of the tasks
+ * \tparam Op Type of the operation, associative and commutative, called as op(Ret, Ret)
+ */
+template<typename Ret, typename Op>
+class ReduceSlot : public Completion
+{
+public:
+    ReduceSlot(size_t count, Op op, const Deadline& deadline) : Completion(count, deadline), m_op(std::move(op))
+    {
+    }
+
+    /**
+     * \brief Reports the outcome of one task, called from the completing thread
+     * 
+     * \param index Index of the task
+     * \param outcome Result or exception of the task
+     */
+    void complete(size_t /*index*/, Expected<Ret>&& outcome)
+    {
+        if (!outcome || !fold(std::move(*outcome)))
+        {
+            if (try_close())
+            {
+                m_failed = true;
+                signal();
+            }
+            return;
+        }
+
+        if (arrive() && try_close())
+        {
+            signal();
+        }
+    }
+
+    /**
+     * \brief Waits for every task, the first failure, or the deadline, then combines the partials
+     * 
+     * \param init Initial value, folded in first
+     * \return std::optional<Ret> Folded value (nullopt on failure)
+     */
+    std::optional<Ret> wait(Ret init)
+    {
+        if (!wait_closed() || m_failed)
+        {
+            return std::nullopt;
+        }
+        try
+        {
+            for (auto& partial : m_partials)
+            {
+                if (partial.value)
+                {
+                    init = m_op(std::move(init), std::move(*partial.value));
+                }
+            }
+            return init;
+        }
+        catch (...)
+        {
+            return std::nullopt;
+        }
+    }
+
+private:
+    struct alignas(64) Partial
+    {
+        std::mutex mutex;
+        std::optional<Ret> value;
+    };
+
+    bool fold(Ret&& value)
+    {
+        Partial& partial = m_partials[thread_shard() % m_partials.size()];
+        std::lock_guard<std::mutex> lock(partial.mutex);
+        try
+        {
+            if (partial.value)
+            {
+                partial.value = m_op(std::move(*partial.value), std::move(value));
+            }
+            else
+            {
+                partial.value.emplace(std::move(value));
+            }
+            return true;
+        }
+        catch (...)
+        {
+            return false;
+        }
+    }
+
+    Op m_op;
+    std::array<Partial, 8> m_partials;
+    bool m_failed = false;
+};
+
+/**
+ * \brief Completion state keeping the k best results in a bounded heap as they arrive
+ * 
+ * Failed tasks are skipped. Given a bound no result can beat, the state closes as soon as the
+ * heap is full of results equal to the bound and every task before the last of them has arrived,
+ * since no pending task could enter it then.
+ * 
+ * \tparam Ret Result type of the tasks
+ * \tparam Func Type of the comparator, returning true if its first argument is better
+ */
+template<typename Ret, typename Func>
+class TopKSlot : public Completion
+{
+public:
+    TopKSlot(size_t count, size_t k, Func comp, std::optional<Ret> bound, const Deadline& deadline)
+        : Completion(k == 0 ? 0 : count, deadline), m_k(k), m_comp(std::move(comp)), m_bound(std::move(bound)),
+          m_arrived(count, false)
+    {
+        m_heap.reserve(std::min(count, k));
+    }
+
+    /**
+     * \brief Reports the outcome of one task, called from the completing thread
+     * 
+     * \param index Index of the task
+     * \param outcome Result or exception of the task
+     */
+    void complete(size_t index, Expected<Ret>&& outcome)
+    {
+        if (settle(index, std::move(outcome)) && try_close())
+        {
+            signal();
+            return;
+        }
+
+        if (arrive() && try_close())
+        {
+            signal();
+        }
+    }
+
+    /**
+     * \brief Waits for every task, the bound, or the deadline
+     * 
+     * \return std::vector<std::pair<int, Ret>> Indices and results, best first (ties by index)
+     */
+    std::vector<std::pair<int, Ret>> wait()
+    {
+        wait_closed();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto results = std::exchange(m_heap, {});
+        try
+        {
+            std::sort_heap(results.begin(), results.end(), Before{this});
+            return results;
+        }
+        catch (...)
+        {
+            return {};
+        }
+    }
+
+private:
+    // Orders entries best first, breaking ties by index; the heap keeps the worst entry on top
+    struct Before
+    {
+        TopKSlot* slot;
+
+        bool operator()(const std::pair<int, Ret>& a, const std::pair<int, Ret>& b) const
+        {
+            return slot->m_comp(a.second, b.second) || (!slot->m_comp(b.second, a.second) && a.first < b.first);
+        }
+    };
+
+    /**
+     * \brief Records the arrival of a task, adding its result if it enters the top k
+     * 
+     * \return bool True once the bound proves the top k final
+     */
+    bool settle(size_t index, Expected<Ret>&& outcome)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_arrived[index] = true;
+        while (m_prefix < m_arrived.size() && m_arrived[m_prefix])
+        {
+            ++m_prefix;
+        }
+        try
+        {
+            if (outcome)
+            {
+                offer(index, std::move(*outcome));
+            }
+            if (m_heap.size() < m_k || !m_bound || m_comp(*m_bound, m_heap.front().second))
+            {
+                return false;
+            }
+            // A pending task before the worst entry could still tie the bound and rank ahead of it
+            const auto& worst = m_heap.front();
+            return m_comp(worst.second, *m_bound) || m_prefix >= static_cast<size_t>(worst.first);
+        }
+        catch (...)
+        {
+            return false;
+        }
+    }
+
+    void offer(size_t index, Ret&& value)
+    {
+        std::pair<int, Ret> entry(static_cast<int>(index), std::move(value));
+        if (m_heap.size() < m_k)
+        {
+            m_heap.push_back(std::move(entry));
+            std::push_heap(m_heap.begin(), m_heap.end(), Before{this});
+        }
+        else if (Before{this}(entry, m_heap.front()))
+        {
+            std::pop_heap(m_heap.begin(), m_heap.end(), Before{this});
+            m_heap.back() = std::move(entry);
+            std::push_heap(m_heap.begin(), m_heap.end(), Before{this});
+        }
+    }
+
+    const size_t m_k;
+    Func m_comp;
+    const std::optional<Ret> m_bound;
+    std::mutex m_mutex;
+    std::vector<std::pair<int, Ret>> m_heap;
+    std::vector<bool> m_arrived;
+    // Number of leading tasks that have all arrived
+    size_t m_prefix = 0;
+};
+
+/**
+ * \brief Completion state folding results into the best one as they arrive
+ * 
+ * Any failing task closes the state early, as does the deadline.
+ * 
+ * \tparam Ret Result type of the tasks
+ * \tparam Func Type of the comparator, returning true if its first argument is better
+ */
+template<typename Ret, typename Func>
+class BestSlot : public Completion
+{
+public:
+    BestSlot(size_t count, Func comp, const Deadline& deadline) : Completion(count, deadline), m_comp(std::move(comp))
+    {
+    }
+
+    /**
+     * \brief Reports the outcome of one task, called from the completing thread
+     * 
+     * \param index Index of the task
+     * \param outcome Result or exception of the task
+     */
+    void complete(size_t index, Expected<Ret>&& outcome)
+    {
+        if (!outcome || !offer(index, std::move(*outcome)))
+        {
+            if (try_close())
+            {
+                m_failed = true;
+                signal();
+            }
+            return;
+        }
+
+        if (arrive() && try_close())
+        {
+            signal();
+        }
+    }
+
+    /**
+     * \brief Waits for every task, the first failure, or the deadline
+     * 
+     * \return std::pair<int, std::optional<Ret>> Index and value of the best result (-1 if none)
+     */
+    std::pair<int, std::optional<Ret>> wait()
+    {
+        if (!wait_closed() || m_failed || m_index < 0)
+        {
+            return {-1, std::optional<Ret>()};
+        }
+        return {m_index, std::move(m_best)};
+    }
+
+private:
+    bool offer(size_t index, Ret&& value)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        try
+        {
+            // Ties go to the lower index, matching a scan in registration order
+            const int candidate = static_cast<int>(index);
+            if (!m_best || m_comp(value, *m_best) || (!m_comp(*m_best, value) && candidate < m_index))
+            {
+                m_best.emplace(std::move(value));
+                m_index = candidate;
+            }
+            return true;
+        }
+        catch (...)
+        {
+            return false;
+        }
+    }
+
+    Func m_comp;
+    std::mutex m_mutex;
+    std::optional<Ret> m_best;
+    int m_index = -1;
+    bool m_failed = false;
+};
+
+/**
+ * \brief Posts one task, reporting its outcome to a shared completion state under its index
+ */
+template<typename TaskType, typename... Args, typename Slot>
+void post_one(const TaskType& task,
+              size_t index,
+              const ArgPack<Args...>& pack,
+              const std::shared_ptr<Slot>& slot,
+              const StopToken& token)
+{
+    using result_type = typename TaskType::return_type;
+
+    task.post([slot, index](Expected<result_type>&& res) { slot->complete(index, std::move(res)); }, token, pack);
+}
+
+/**
+ * \brief Posts every task of a range, reporting each outcome to a shared completion state
+ * 
+ * \tparam Range Type of task container
+ * \tparam Args Argument types for the tasks
+ * \tparam Slot Type of the completion state, providing token() and complete(index, outcome)
+ * \param range Container of tasks
+ * \param pack Arguments shared by the tasks
+ * \param slot Completion state kept alive by the posted tasks
+ */
+template<typename Range, typename... Args, typename Slot>
+void post_all(const Range& range, const ArgPack<Args...>& pack, const std::shared_ptr<Slot>& slot)
+{
+    const auto token = slot->token();
+    // Dispatch to the pool first, so inline tasks run here while the others proceed
+    for (bool runsInline : {false, true})
+    {
+        size_t index = 0;
+        for (const auto& task : range)
+        {
+            if (task.is_inline() == runsInline)
+            {
+                post_one(task, index, pack, slot, token);
+            }
+            ++index;
+        }
+    }
+}
+
+/**
+ * \brief Start hook of a combinator, see TaskAccess: posts every task into a fresh slot and hands over its result
+ * 
+ * The result is handed over on the thread closing the slot, or on the pool at the deadline, so no thread waits
+ * for the tasks. An exception starting them is handed over instead.
+ * 
+ * \tparam Result Result type of the combinator
+ * \param makeSlot Creates the completion slot of one execution, providing result()
+ * \param range Container of tasks
+ * \param pack Arguments shared by the tasks
+ */
+template<typename Result, typename MakeSlot, typename Range, typename... Args>
+auto slot_start(MakeSlot makeSlot, const Range& range, const ArgPack<Args...>& pack)
+{
+    return [makeSlot = std::move(makeSlot), range, pack](std::function<void(Expected<Result>&&)> done)
+    {
+        decltype(makeSlot()) slot;
+        try
+        {
+            slot = makeSlot();
+            post_all(range, pack, slot);
+        }
+        catch (...)
+        {
+            done(Expected<Result>(std::current_exception()));
+            return;
+        }
+        // The slot owns its continuation, which therefore only keeps a plain pointer back
+        auto* state = slot.get();
+        slot->continue_with(slot,
+                            pool_of(range),
+                            [state, done = std::move(done)]() { done(Expected<Result>(state->result())); });
+    };
+}
+
+/**
+ * \brief Runs every task and waits for the first result accepted by a predicate
+ * 
+ * \tparam Func Type of condition function
+ * \tparam Range Type of task container
+ * \tparam Args Argument types for the tasks
+ * \param checkFun Condition function, may be called concurrently from several threads
+ * \param range Container of tasks
+ * \param pack Arguments shared by the tasks
+ * \param deadline Time limit
+ * \return std::pair<int, std::optional<result_type>> Index and result (if found, -1 if none)
+ */
+template<typename Func, typename Range, typename... Args>
+auto getAnyWithResultPair(Func checkFun,
+                          const Range& range,
+                          const ArgPack<Args...>& pack,
+                          const Deadline& deadline)
+    -> std::pair<int, std::optional<typename Range::value_type::return_type>>
+{
+    using result_type = typename Range::value_type::return_type;
+
+    auto slot = make_pooled<CompletionSlot<result_type, Func>>(range.size(), std::move(checkFun), deadline);
+    post_all(range, pack, slot);
+    return slot->wait();
+}
+
+/**
+ * \brief Runs every task and waits for the first successful result
+ * 
+ * \tparam Range Type of task container
+ * \tparam Args Argument types for the tasks
+ * \param range Container of tasks
+ * \param pack Arguments shared by the tasks
+ * \param deadline Time limit
+ * \return std::pair<int, std::optional<result_type>> Index and result of the completed task (-1 if none)
+ */
+template<typename Range, typename... Args>
+auto getAnyResultPair(const Range& range, const ArgPack<Args...>& pack, const Deadline& deadline)
+    -> std::pair<int, std::optional<typename Range::value_type::return_type>>
+{
+    return getAnyWithResultPair(AcceptAll(), range, pack, deadline);
+}
+
+/**
+ * \brief Starts tasks one after another and waits for the first successful result
+ * 
+ * Each task starts once the previous one failed or its delay passed without a result; the first
+ * success stops the started tasks and the rest never start.
+ * 
+ * \tparam DelayOf Type of callable returning the delay after starting the task at an index
+ * \tparam Range Type of task container
+ * \tparam Args Argument types for the tasks
+ * \param delayOf Hedging delay per task, called on the waiting thread
+ * \param range Container of tasks
+ * \param pack Arguments shared by the tasks
+ * \param deadline Time limit
+ * \return std::pair<int, std::optional<result_type>> Index and result of the completed task (-1 if none)
+ */
+template<typename DelayOf, typename Range, typename... Args>
+auto getHedgedResultPair(DelayOf&& delayOf,
+                         const Range& range,
+                         const ArgPack<Args...>& pack,
+                         const Deadline& deadline)
+    -> std::pair<int, std::optional<typename Range::value_type::return_type>>
+{
+    using result_type = typename Range::value_type::return_type;
+
+    auto slot = make_pooled<HedgedSlot<result_type>>(range.size(), deadline);
+    const auto token = slot->token();
+    const auto& until = token.deadline();
+    size_t started = 0;
+    for (const auto& task : range)
+    {
+        if (started > 0)
+        {
+            const auto due = std::min(Deadline::within(delayOf(started - 1)).time(), until.time());
+            if (!slot->wait_backup(started, due) || until.expired())
+            {
+                break;
+            }
+        }
+        post_one(task, started++, pack, slot, token);
+    }
+    return slot->wait();
+}
+
+/**
+ * \brief Runs every task and waits for the first results accepted by a predicate
+ * 
+ * \tparam Func Type of condition function
+ * \tparam Range Type of task container
+ * \tparam Args Argument types for the tasks
+ * \param quorum Number of results to wait for
+ * \param checkFun Condition function, may be called concurrently from several threads
+ * \param range Container of tasks
+ * \param pack Arguments shared by the tasks
+ * \param deadline Time limit
+ * \return std::vector<std::pair<int, result_type>> Indices and results in arrival order (fewer than quorum if missed)
+ */
+template<typename Func, typename Range, typename... Args>
+auto getQuorumResults(size_t quorum,
+                      Func checkFun,
+                      const Range& range,
+                      const ArgPack<Args...>& pack,
+                      const Deadline& deadline)
+    -> std::vector<std::pair<int, typename Range::value_type::return_type>>
+{
+    using result_type = typename Range::value_type::return_type;
+
+    auto slot = make_pooled<QuorumSlot<result_type, Func>>(range.size(), quorum, std::move(checkFun), deadline);
+    if (quorum > 0)
+    {
+        post_all(range, pack, slot);
+    }
+    return slot->wait();
+}
+
+/**
+ * \brief Runs every task and folds the results with an associative operation
+ * 
+ * \tparam Op Type of the operation, called as op(result_type, result_type)
+ * \tparam Range Type of task container
+ * \tparam Args Argument types for the tasks
+ * \param init Initial value
+ * \param op Associative and commutative operation
+ * \param range Container of tasks
+ * \param pack Arguments shared by the tasks
+ * \param deadline Time limit
+ * \return std::optional<result_type> Folded value (nullopt if any task failed or timed out)
+ */
+template<typename Op, typename Range, typename... Args>
+auto getReduceResult(typename Range::value_type::return_type init,
+                     Op op,
+                     const Range& range,
+                     const ArgPack<Args...>& pack,
+                     const Deadline& deadline) -> std::optional<typename Range::value_type::return_type>
+{
+    using result_type = typename Range::value_type::return_type;
+
+    auto slot = make_pooled<ReduceSlot<result_type, Op>>(range.size(), std::move(op), deadline);
+    post_all(range, pack, slot);
+    return slot->wait(std::move(init));
+}
+
+/**
+ * \brief Runs every task and keeps the k best results according to a comparator
+ * 
+ * \tparam Func Type of comparator function, returning true if its first argument is better
+ * \tparam Range Type of task container
+ * \tparam Args Argument types for the tasks
+ * \param k Number of results to keep
+ * \param comp Comparator function, called under a lock
+ * \param bound Value no result can beat, enabling the early stop (nullopt for none)
+ * \param range Container of tasks
+ * \param pack Arguments shared by the tasks
+ * \param deadline Time limit
+ * \return std::vector<std::pair<int, result_type>> Indices and results, best first
+ */
+template<typename Func, typename Range, typename... Args>
+auto getTopKResults(size_t k,
+                    Func comp,
+                    std::optional<typename Range::value_type::return_type> bound,
+                    const Range& range,
+                    const ArgPack<Args...>& pack,
+                    const Deadline& deadline) -> std::vector<std::pair<int, typename Range::value_type::return_type>>
+{
+    using result_type = typename Range::value_type::return_type;
+
+    auto slot = make_pooled<TopKSlot<result_type, Func>>(range.size(), k, std::move(comp), std::move(bound), deadline);
+    if (k > 0)
+    {
+        post_all(range, pack, slot);
+    }
+    return slot->wait();
+}
+
+/**
+ * \brief Runs every task and waits for the best result according to a comparator
+ * 
+ * Results are compared as they arrive; the first failure ends the wait early.
+ * 
+ * \tparam Func Type of comparator function, returning true if its first argument is better
+ * \tparam Range Type of task container
+ * \tparam Args Argument types for the tasks
+ * \param comp Comparator function
+ * \param range Container of tasks
+ * \param pack Arguments shared by the tasks
+ * \param deadline Time limit
+ * \return std::pair<int, std::optional<result_type>> Index and value of the best result (-1 on failure)
+ */
+template<typename Func, typename Range, typename... Args>
+auto getBestResultPair(Func comp, const Range& range, const ArgPack<Args...>& pack, const Deadline& deadline)
+    -> std::pair<int, std::optional<typename Range::value_type::return_type>>
+{
+    using result_type = typename Range::value_type::return_type;
+
+    auto slot = make_pooled<BestSlot<result_type, Func>>(range.size(), std::move(comp), deadline);
+    post_all(range, pack, slot);
+    return slot->wait();
+}
+
+/**
+ * \brief Waits for the first task satisfying a condition in order
+ * 
+ * \tparam Func Type of condition function
+ * \tparam Range Type of future container
+ * \param checkFun Condition function
+ * \param funcs Container of futures
+ * \param deadline Time limit
+ * \return std::pair<int, std::optional<result_type>> Index and result (if found, -1 if none)
+ */
+template<typename Func, typename Range>
+auto getOrderWithResultPair(Func&& checkFun, Range&& funcs, Deadline deadline)
+    -> std::pair<int, std::optional<range_trait_t<typename std::decay_t<decltype(*std::begin(funcs))>>>>
+{
+    using result_type = range_trait_t<typename std::decay_t<decltype(*std::begin(funcs))>>;
+    deadline = deadline.start();
+    const int count = static_cast<int>(funcs.size());
+
+    for (int i = 0; i < count; ++i)
+    {
+        // Wait for current task until the deadline; past it, only tasks already done are considered
+        const auto status = aux::wait(funcs[i], deadline);
+
+        if (status == std::future_status::timeout)
+        {
+            // Skip to next task on timeout
+            continue;
+        }
+
+        // Process result if ready
+        if (status == std::future_status::ready)
+        {
+            try
+            {
+                auto res = funcs[i].get();
+                if (checkFun(res))
+                {
+                    return {i, std::move(res)};
+                }
+            }
+            catch (...)
+            {
+                // Continue to next task on exception
+            }
+        }
+    }
+
+    return {-1, std::optional<result_type>()};
+}
+} // namespace aux
+
+/**
+ * \brief Executes all tasks and collects their results
+ * 
+ * \tparam Range Type of task container
+ * \tparam Args Argument types for the tasks
+ * \param range Container of tasks
+ * \param deadline Time limit, a budget counts from when the returned task runs
+ * \param args Arguments to pass to tasks
+ * \return Task<std::optional<std::vector<result_type>>()> Task producing the results (nullopt on failure)
+ */
+template<typename Range, typename... Args>
+inline auto All(const Range& range,
+                Deadline deadline,
+                Args&&...args) -> Task<std::optional<std::vector<typename Range::value_type::return_type>>()>
+{
+    using result_type = typename Range::value_type::return_type;
+    using vector_type = std::vector<result_type>;
+
+    auto pack = aux::make_args(std::forward<Args>(args)...);
+    auto makeSlot = [count = range.size(), deadline]()
+    { return aux::make_pooled<aux::AllSlot<result_type>>(count, deadline); };
+    Task<std::optional<vector_type>()> task(
+        [range, pack, makeSlot]()
+        {
+            try
+            {
+                auto slot = makeSlot();
+                aux::post_all(range, pack, slot);
+                return slot->wait();
+            }
+            catch (...)
+            {
+                return std::optional<vector_type>(std::nullopt);
+            }
+        },
+        aux::pool_of(range));
+    return aux::TaskAccess::with_start(std::move(task),
+                                       aux::slot_start<std::optional<vector_type>>(makeSlot, range, pack));
+}
+
+/**
+ * \brief Executes all tasks and reports the outcome of each, keeping what finished in time
+ * 
+ * Unlike All, a task missing the deadline or throwing does not discard the other results.
+ * 
+ * \tparam Range Type of task container
+ * \tparam Args Argument types for the tasks
+ * \param range Container of tasks
+ * \param deadline Time limit, a budget counts from when the returned task runs
+ * \param args Arguments to pass to tasks
+ * \return Task<std::vector<Outcome<result_type>>()> Task producing one outcome per task, in order
+ */
+template<typename Range, typename... Args>
+inline auto AllPartial(const Range& range, Deadline deadline, Args&&...args)
+    -> Task<std::vector<Outcome<typename Range::value_type::return_type>>()>
+{
+    using result_type = typename Range::value_type::return_type;
+    using vector_type = std::vector<Outcome<result_type>>;
+
+    auto pack = aux::make_args(std::forward<Args>(args)...);
+    return Task<vector_type()>(
+        [range, pack = std::move(pack), deadline]() mutable
+        {
+            StopSource stop(deadline);
+            aux::ScopedStop stopRemaining(stop);
+            const auto& until = stop.deadline();
+            auto funcs = aux::transform(range, pack, stop.get_token());
+            vector_type res;
+            res.reserve(funcs.size());
+
+            for (auto& fut : funcs)
+            {
+                // Past the deadline, only tasks already done are collected
+                if (aux::wait(fut, until) != std::future_status::ready)
+                {
+                    res.push_back(Outcome<result_type>::timed_out());
+                    continue;
+                }
+
+                try
+                {
+                    res.emplace_back(Expected<result_type>(fut.get()));
+                }
+                catch (...)
+                {
+                    res.emplace_back(Expected<result_type>(std::current_exception()));
+                }
+            }
+            return res;
+        },
+        aux::pool_of(range));
+}
+
+/**
+ * \brief Executes all tasks and folds their results in completion order
+ * 
+ * Results are folded as they arrive into per-thread partial accumulators, so no intermediate
+ * vector is built; the operation must therefore be associative and commutative.
+ * 
+ * \tparam Op Type of the operation, called as op(result_type, result_type)
+ * \tparam Range Type of task container
+ * \tparam Args Argument types for the tasks
+ * \param init Initial value
+ * \param op Operation combining two values
+ * \param range Container of tasks
+ * \param deadline Time limit, a budget counts from when the returned task runs
+ * \param args Arguments to pass to tasks
+ * \return Task<std::optional<result_type>()> Task producing the folded value (nullopt on failure)
+ */
+template<typename Op, typename Range, typename... Args>
+inline auto Reduce(typename Range::value_type::return_type init,
+                   Op op,
+                   const Range& range,
+                   Deadline deadline,
+                   Args&&...args) -> Task<std::optional<typename Range::value_type::return_type>()>
+{
+    using result_type = typename Range::value_type::return_type;
+
+    return Task<std::optional<result_type>()>(
+        [init = std::move(init),
+         op = std::move(op),
+         range,
+         deadline,
+         pack = aux::make_args(std::forward<Args>(args)...)]() mutable
+        {
+            try
+            {
+                return aux::getReduceResult(std::move(init), op, range, pack, deadline);
+            }
+            catch (...)
+            {
+                return std::optional<result_type>();
+            }
+        },
+        aux::pool_of(range));
+}
+
+/**
+ * \brief Executes all tasks once and returns the best result together with its index
+ * 
+ * The comparator is applied as results arrive, so no intermediate vector is built and
+ * the result type needs neither copying nor equality comparison.
+ * 
+ * \tparam Func Type of comparator function
+ * \tparam Range Type of task container
+ * \tparam Args Argument types for the tasks
+ * \param fn Comparator function
+ * \param range Container of tasks
+ * \param deadline Time limit, a budget counts from when the returned task runs
+ * \param args Arguments to pass to tasks
+ * \return Task<std::pair<int, std::optional<result_type>>()> Task producing index and best result (-1 on failure)
+ */
+template<typename Func, typename Range, typename... Args>
+inline auto BestIndexed(Func fn, const Range& range, Deadline deadline, Args&&...args)
+    -> Task<std::pair<int, std::optional<typename Range::value_type::return_type>>()>
+{
+    using result_type = typename Range::value_type::return_type;
+    using pair_type = std::pair<int, std::optional<result_type>>;
+
+    return Task<pair_type()>(
+        [range, fn = std::move(fn), deadline, pack = aux::make_args(std::forward<Args>(args)...)]() mutable
+        {
+            try
+            {
+                return aux::getBestResultPair(fn, range, pack, deadline);
+            }
+            catch (...)
+            {
+                return std::make_pair(-1, std::optional<result_type>());
+            }
+        },
+        aux::pool_of(range));
+}
+
+/**
+ * \brief Executes all tasks and returns the best result according to a comparator
+ * 
+ * \tparam Func Type of comparator function
+ * \tparam Range Type of task container
+ * \tparam Args Argument types for the tasks
+ * \param fn Comparator function
+ * \param range Container of tasks
+ * \param deadline Time limit, a budget counts from when the returned task runs
+ * \param args Arguments to pass to tasks
+ * \return Task<std::optional<result_type>()> Task producing the best result (nullopt on failure)
+ */
+template<typename Func, typename Range, typename... Args>
+inline auto Best(Func fn, const Range& range, Deadline deadline, Args&&...args)
+    -> Task<std::optional<typename Range::value_type::return_type>()>
+{
+    using result_type = typename Range::value_type::return_type;
+
+    return Task<std::optional<result_type>()>(
+        [best = BestIndexed(std::move(fn), range, deadline, std::forward<Args>(args)...)]()
+        { return best.get().second; },
+        aux::pool_of(range));
+}
+
+/**
+ * \brief Executes all tasks and returns the k best results, stopping once no pending task can enter them
+ * 
+ * Failed tasks are skipped; past the deadline, the best results that arrived in time are returned.
+ * 
+ * \tparam Func Type of comparator function
+ * \tparam Range Type of task container
+ * \tparam Args Argument types for the tasks
+ * \param k Number of results to return
+ * \param fn Comparator function, returning true if its first argument is better
+ * \param bound Value no result can beat (e.g., a lower bound on a cost), nullopt for none
+ * \param range Container of tasks
+ * \param deadline Time limit, a budget counts from when the returned task runs
+ * \param args Arguments to pass to tasks
+ * \return Task<std::vector<std::pair<int, result_type>>()> Task producing indices and results, best first
+ */
+template<typename Func, typename Range, typename... Args>
+inline auto TopKBounded(size_t k,
+                        Func fn,
+                        std::optional<typename Range::value_type::return_type> bound,
+                        const Range& range,
+                        Deadline deadline,
+                        Args&&...args) -> Task<std::vector<std::pair<int, typename Range::value_type::return_type>>()>
+{
+    using result_type = typename Range::value_type::return_type;
+    using vector_type = std::vector<std::pair<int, result_type>>;
+
+    return Task<vector_type()>(
+        [k,
+         fn = std::move(fn),
+         bound = std::move(bound),
+         range,
+         deadline,
+         pack = aux::make_args(std::forward<Args>(args)...)]() mutable
+        {
+            try
+            {
+                return aux::getTopKResults(k, fn, bound, range, pack, deadline);
+            }
+            catch (...)
+            {
+                return vector_type();
+            }
+        },
+        aux::pool_of(range));
+}
+
+/**
+ * \brief Executes all tasks and returns the k best results, keeping a bounded heap as they arrive
+ * 
+ * Failed tasks are skipped; past the deadline, the best results that arrived in time are returned.
+ * 
+ * \tparam Func Type of comparator function
+ * \tparam Range Type of task container
+ * \tparam Args Argument types for the tasks
+ * \param k Number of results to return
+ * \param fn Comparator function, returning true if its first argument is better
+ * \param range Container of tasks
+ * \param deadline Time limit, a budget counts from when the returned task runs
+ * \param args Arguments to pass to tasks
+ * \return Task<std::vector<std::pair<int, result_type>>()> Task producing indices and results, best first
+ */
+template<typename Func, typename Range, typename... Args>
+inline auto TopK(size_t k, Func fn, const Range& range, Deadline deadline, Args&&...args)
+    -> Task<std::vector<std::pair<int, typename Range::value_type::return_type>>()>
+{
+    return TopKBounded(k, std::move(fn), std::nullopt, range, deadline, std::forward<Args>(args)...);
+}
+
+/**
+ * \brief Executes tasks and returns the first completed result
+ * 
+ * \tparam Range Type of task container
+ * \tparam Args Argument types for the tasks
+ * \param range Container of tasks
+ * \param deadline Time limit, a budget counts from when the returned task runs
+ * \param args Arguments to pass to tasks
+ * \return Task<std::pair<int, std::optional<result_type>>()> Task producing index and result (-1 on failure)
+ */
+template<typename Range, typename... Args>
+inline auto Any(const Range& range,
+                Deadline deadline,
+                Args&&...args) -> Task<std::pair<int, std::optional<typename Range::value_type::return_type>>()>
+{
+    using result_type = typename Range::value_type::return_type;
+    using pair_type = std::pair<int, std::optional<result_type>>;
+
+    auto pack = aux::make_args(std::forward<Args>(args)...);
+    Task<pair_type()> task(
+        [range, deadline, pack]()
+        {
+            try
+            {
+                return aux::getAnyResultPair(range, pack, deadline);
+            }
+            catch (...)
+            {
+                return std::make_pair(-1, std::optional<result_type>());
+            }
+        },
+        aux::pool_of(range));
+    auto makeSlot = [count = range.size(), deadline]()
+    { return aux::make_pooled<aux::CompletionSlot<result_type>>(count, aux::AcceptAll(), deadline); };
+    return aux::TaskAccess::with_start(std::move(task), aux::slot_start<pair_type>(makeSlot, range, pack));
+}
+
+/**
+ * \brief Starts tasks one after another and returns the first completed result
+ * 
+ * The first task starts right away; each further task starts only if no result arrived within the
+ * delay, or once every started task failed. The first success stops the started tasks and the rest
+ * never run, which protects the tail latency at a fraction of the work of Any.
+ * 
+ * \tparam Range Type of task container
+ * \tparam Args Argument types for the tasks
+ * \param range Container of tasks, in the order to start them
+ * \param delay Time to wait for a result before starting the next task
+ * \param deadline Time limit, a budget counts from when the returned task runs
+ * \param args Arguments to pass to tasks
+ * \return Task<std::pair<int, std::optional<result_type>>()> Task producing index and result (-1 on failure)
+ */
+template<typename Range, typename... Args>
+inline auto Hedged(const Range& range, std::chrono::nanoseconds delay, Deadline deadline, Args&&...args)
+    -> Task<std::pair<int, std::optional<typename Range::value_type::return_type>>()>
+{
+    using result_type = typename Range::value_type::return_type;
+    using pair_type = std::pair<int, std::optional<result_type>>;
+
+    return Task<pair_type()>(
+        [range, delay, deadline, pack = aux::make_args(std::forward<Args>(args)...)]() mutable
+        {
+            try
+            {
+                return aux::getHedgedResultPair([delay](size_t) { return delay; }, range, pack, deadline);
+            }
+            catch (...)
+            {
+                return std::make_pair(-1, std::optional<result_type>());
+            }
+        },
+        aux::pool_of(range));
+}
+
+/**
+ * \brief Executes tasks and returns the first results satisfying a condition, once there are enough
+ * 
+ * The remaining tasks are stopped as soon as the quorum is reached.
+ * 
+ * \tparam Func Type of condition function
+ * \tparam Range Type of task container
+ * \tparam Args Argument types for the tasks
+ * \param quorum Number of results to wait for
+ * \param fn Condition function
+ * \param range Container of tasks
+ * \param deadline Time limit, a budget counts from when the returned task runs
+ * \param args Arguments to pass to tasks
+ * \return Task<std::vector<std::pair<int, result_type>>()> Task producing indices and results in arrival order
+ *         (fewer than quorum if the tasks failed or the deadline passed first)
+ */
+template<typename Func, typename Range, typename... Args>
+inline auto QuorumWith(size_t quorum, Func fn, const Range& range, Deadline deadline, Args&&...args)
+    -> Task<std::vector<std::pair<int, typename Range::value_type::return_type>>()>
+{
+    using result_type = typename Range::value_type::return_type;
+    using vector_type = std::vector<std::pair<int, result_type>>;
+
+    return Task<vector_type()>(
+        [quorum, fn = std::move(fn), range, deadline, pack = aux::make_args(std::forward<Args>(args)...)]() mutable
+        {
+            try
+            {
+                return aux::getQuorumResults(quorum, fn, range, pack, deadline);
+            }
+            catch (...)
+            {
+                return vector_type();
+            }
+        },
+        aux::pool_of(range));
+}
+
+/**
+ * \brief Executes tasks and returns the first successful results, once there are enough
+ * 
+ * \tparam Range Type of task container
+ * \tparam Args Argument types for the tasks
+ * \param quorum Number of results to wait for
+ * \param range Container of tasks
+ * \param deadline Time limit, a budget counts from when the returned task runs
+ * \param args Arguments to pass to tasks
+ * \return Task<std::vector<std::pair<int, result_type>>()> Task producing indices and results in arrival order
+ *         (fewer than quorum if the tasks failed or the deadline passed first)
+ */
+template<typename Range, typename... Args>
+inline auto Quorum(size_t quorum, const Range& range, Deadline deadline, Args&&...args)
+    -> Task<std::vector<std::pair<int, typename Range::value_type::return_type>>()>
+{
+    return QuorumWith(quorum, aux::AcceptAll(), range, deadline, std::forward<Args>(args)...);
+}
+
+/**
+ * \brief Executes tasks and returns the first result satisfying a condition
+ * 
+ * \tparam Func Type of condition function
+ * \tparam Range Type of task container
+ * \tparam Args Argument types for the tasks
+ * \param fn Condition function
+ * \param range Container of tasks
+ * \param deadline Time limit, a budget counts from when the returned task runs
+ * \param args Arguments to pass to tasks
+ * \return Task<std::pair<int, std::optional<result_type>>()> Task producing index and result (-1 on failure)
+ */
+template<typename Func, typename Range, typename... Args>
+inline auto AnyWith(Func fn, const Range& range, Deadline deadline, Args&&...args)
+    -> Task<std::pair<int, std::optional<typename Range::value_type::return_type>>()>
+{
+    using result_type = typename Range::value_type::return_type;
+    using pair_type = std::pair<int, std::optional<result_type>>;
+
+    auto pack = aux::make_args(std::forward<Args>(args)...);
+    Task<pair_type()> task(
+        [range, fn, deadline, pack]() mutable
+        {
+            try
+            {
+                return aux::getAnyWithResultPair(fn, range, pack, deadline);
+            }
+            catch (...)
+            {
+                return std::make_pair(-1, std::optional<result_type>());
+            }
+        },
+        aux::pool_of(range));
+    auto makeSlot = [count = range.size(), fn = std::move(fn), deadline]()
+    { return aux::make_pooled<aux::CompletionSlot<result_type, Func>>(count, fn, deadline); };
+    return aux::TaskAccess::with_start(std::move(task), aux::slot_start<pair_type>(std::move(makeSlot), range, pack));
+}
+
+/**
+ * \brief Executes tasks in order and returns the first result satisfying a condition
+ * 
+ * \tparam Func Type of condition function
+ * \tparam Range Type of task container
+ * \tparam Args Argument types for the tasks
+ * \param fn Condition function
+ * \param range Container of tasks
+ * \param deadline Time limit, a budget counts from when the returned task runs
+ * \param args Arguments to pass to tasks
+ * \return Task<std::pair<int, std::optional<result_type>>()> Task producing index and result (-1 on failure)
+ */
+template<typename Func, typename Range, typename... Args>
+inline auto OrderWith(Func fn, const Range& range, Deadline deadline, Args&&...args)
+    -> Task<std::pair<int, std::optional<typename Range::value_type::return_type>>()>
+{
+    using result_type = typename Range::value_type::return_type;
+    using pair_type = std::pair<int, std::optional<result_type>>;
+
+    return Task<pair_type()>(
+        [range, fn = std::move(fn), deadline, pack = aux::make_args(std::forward<Args>(args)...)]() mutable
+        {
+            StopSource stop(deadline);
+            aux::ScopedStop stopRemaining(stop);
+            try
+            {
+                auto funcs = aux::transform(range, pack, stop.get_token());
+                return aux::getOrderWithResultPair(fn, std::move(funcs), stop.deadline());
+            }
+            catch (...)
+            {
+                return std::make_pair(-1, std::optional<result_type>());
+            }
+        },
+        aux::pool_of(range));
+}
+
+/**
+ * \brief Row-major matrix of batch results, one row per input and one column per function
+ * 
+ * \tparam T Result type of the functions
+ */
+template<typename T>
+class ResultMatrix
+{
+public:
+    ResultMatrix() = default;
+
+    ResultMatrix(size_t rows, std::vector<std::string> names)
+        : m_rows(rows), m_names(std::move(names)), m_cells(rows * m_names.size())
+    {
+    }
+
+    size_t rows() const noexcept
+    {
+        return m_rows;
+    }
+
+    size_t cols() const noexcept
+    {
+        return m_names.size();
+    }
+
+    /**
+     * \brief Names of the functions, one per column
+     */
+    const std::vector<std::string>& names() const noexcept
+    {
+        return m_names;
+    }
+
+    /**
+     * \brief Result of one function for one input (nullopt if it failed or timed out)
+     */
+    std::optional<T>& operator()(size_t row, size_t col)
+    {
+        return m_cells[row * cols() + col];
+    }
+
+    const std::optional<T>& operator()(size_t row, size_t col) const
+    {
+        return m_cells[row * cols() + col];
+    }
+
+    /**
+     * \brief Checks whether every function produced a result for an input
+     */
+    bool complete(size_t row) const
+    {
+        const auto first = m_cells.begin() + static_cast<std::ptrdiff_t>(row * cols());
+        return std::all_of(first,
+                           first + static_cast<std::ptrdiff_t>(cols()),
+                           [](const std::optional<T>& cell) { return cell.has_value(); });
+    }
+
+private:
+    size_t m_rows = 0;
+    std::vector<std::string> m_names;
+    std::vector<std::optional<T>> m_cells;
+};
+
+/**
+ * \brief Log-linear latency histogram in the style of HdrHistogram
+ * 
+ * Each power of two is split into 16 linear buckets, bounding the relative error of a
+ * recorded value by 1/16; values below 16 ns are exact.
+ */
+class LatencyHistogram
+{
+public:
+    static constexpr size_t sub_buckets = 16;
+    static constexpr size_t max_exponent = 44; // ~4.9 hours, larger values share the last bucket
+    static constexpr size_t bucket_count = sub_buckets + (max_exponent - 3) * sub_buckets;
+
+    /**
+     * \brief Bucket holding a latency
+     */
+    static size_t bucket_of(std::chrono::nanoseconds latency) noexcept
+    {
+        const auto value = static_cast<uint64_t>(std::max<int64_t>(latency.count(), 0));
+        if (value < sub_buckets)
+        {
+            return static_cast<size_t>(value);
+        }
+
+        size_t exponent = 0;
+        for (size_t shift = 32; shift > 0; shift /= 2)
+        {
+            if (value >> (exponent + shift))
+            {
+                exponent += shift;
+            }
+        }
+        if (exponent > max_exponent)
+        {
+            return bucket_count - 1;
+        }
+        const auto sub = static_cast<size_t>(value >> (exponent - 4)) - sub_buckets;
+        return sub_buckets + (exponent - 4) * sub_buckets + sub;
+    }
+
+    /**
+     * \brief Smallest latency falling into a bucket
+     */
+    static std::chrono::nanoseconds lower_bound(size_t bucket) noexcept
+    {
+        if (bucket < sub_buckets)
+        {
+            return std::chrono::nanoseconds(static_cast<int64_t>(bucket));
+        }
+        const size_t exponent = (bucket - sub_buckets) / sub_buckets + 4;
+        const size_t sub = (bucket - sub_buckets) % sub_buckets;
+        return std::chrono::nanoseconds(static_cast<int64_t>((sub_buckets + sub) << (exponent - 4)));
+    }
+
+    void record(std::chrono::nanoseconds latency) noexcept
+    {
+        ++m_counts[bucket_of(latency)];
+    }
+
+    /**
+     * \brief Adds the counts of another histogram
+     */
+    void merge(const std::array<uint64_t, bucket_count>& counts) noexcept
+    {
+        for (size_t i = 0; i < bucket_count; ++i)
+        {
+            m_counts[i] += counts[i];
+        }
+    }
+
+    /**
+     * \brief Number of recorded latencies
+     */
+    uint64_t count() const noexcept
+    {
+        uint64_t total = 0;
+        for (auto c : m_counts)
+        {
+            total += c;
+        }
+        return total;
+    }
+
+    /**
+     * \brief Latency below which a fraction of the recorded values fall
+     * 
+     * \param quantile Fraction in [0, 1] (e.g., 0.99)
+     * \return std::chrono::nanoseconds Upper edge of the bucket holding the quantile, 0 if empty
+     */
+    std::chrono::nanoseconds percentile(double quantile) const noexcept
+    {
+        const uint64_t total = count();
+        if (total == 0)
+        {
+            return std::chrono::nanoseconds(0);
+        }
+
+        const auto rank = std::max<uint64_t>(static_cast<uint64_t>(std::ceil(quantile * static_cast<double>(total))), 1);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < bucket_count; ++i)
+        {
+            seen += m_counts[i];
+            if (seen >= rank)
+            {
+                return i + 1 < bucket_count ? lower_bound(i + 1) - std::chrono::nanoseconds(1) : lower_bound(i);
+            }
+        }
+        return lower_bound(bucket_count - 1);
+    }
+
+    /**
+     * \brief Raw bucket counts
+     */
+    const std::array<uint64_t, bucket_count>& counts() const noexcept
+    {
+        return m_counts;
+    }
+
+private:
+    std::array<uint64_t, bucket_count> m_counts{};
+};
+
+/**
+ * \brief Snapshot of the statistics recorded for one Worker function
+ */
+struct FunctionStats
+{
+    std::string name;
+    uint64_t completed = 0; // Returned a value within its execution's deadline
+    uint64_t timed_out = 0; // Returned after its execution's deadline had passed
+    uint64_t failed = 0;    // Threw an exception
+    uint64_t wins = 0;      // Provided the result of execute_any, execute_best, ...
+    LatencyHistogram latency;
+};
+
+namespace aux
+{
+/**
+ * \brief Per-function statistics, sharded by thread so concurrent recording does not contend
+ * 
+ * Shards are only allocated once recording is enabled. Independently of the statistics, the
+ * recorder can keep the running estimates adaptive ordering uses: a moving average of the
+ * latency and the rate at which results pass a condition.
+ */
+class StatsRecorder
+{
+public:
+    static constexpr size_t shard_count = 8;
+
+    StatsRecorder() = default;
+    StatsRecorder(const StatsRecorder&) = delete;
+    StatsRecorder& operator=(const StatsRecorder&) = delete;
+
+    /**
+     * \brief Starts or stops recording, must not race with itself
+     */
+    void enable(bool enabled)
+    {
+        if (enabled && !m_owner)
+        {
+            m_owner = std::make_unique<Shard[]>(shard_count);
+            m_shards.store(m_owner.get(), std::memory_order_release);
+        }
+        m_active.store(enabled ? m_owner.get() : nullptr, std::memory_order_release);
+    }
+
+    /**
+     * \brief Starts or stops tracking the average latency
+     */
+    void enable_timing(bool enabled) noexcept
+    {
+        m_timed.store(enabled, std::memory_order_relaxed);
+    }
+
+    /**
+     * \brief Runs a function, recording its latency and outcome when enabled
+     * 
+     * \param token Token of the execution, providing its deadline
+     * \param body Function to run
+     */
+    template<typename Body>
+    auto record(const StopToken& token, Body&& body) -> decltype(body())
+    {
+        Shard* shards = m_active.load(std::memory_order_acquire);
+        if (!shards && !m_timed.load(std::memory_order_relaxed))
+        {
+            return body();
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        try
+        {
+            auto result = body();
+            finish(shards, start, token.deadline(), false);
+            return result;
+        }
+        catch (...)
+        {
+            finish(shards, start, token.deadline(), true);
+            throw;
+        }
+    }
+
+    /**
+     * \brief Records whether a result of the function passed a condition
+     * 
+     * Updates are approximate under contention; the counts are halved periodically so the
+     * estimate follows changes in behavior.
+     */
+    void observe(bool passed) noexcept
+    {
+        const auto checks = m_checks.load(std::memory_order_relaxed) + 1;
+        const auto passes = m_passes.load(std::memory_order_relaxed) + (passed ? 1 : 0);
+        const bool halve = checks >= observation_window;
+        m_checks.store(halve ? checks / 2 : checks, std::memory_order_relaxed);
+        m_passes.store(halve ? passes / 2 : passes, std::memory_order_relaxed);
+    }
+
+    /**
+     * \brief Expected passing results per nanosecond of latency, higher is better
+     * 
+     * Without observations the pass rate is 1/2, and without timings the latency counts as 1 ns.
+     */
+    double score() const noexcept
+    {
+        const auto checks = static_cast<double>(m_checks.load(std::memory_order_relaxed));
+        const auto passes = static_cast<double>(m_passes.load(std::memory_order_relaxed));
+        const auto latency = static_cast<double>(m_latency.load(std::memory_order_relaxed));
+        return (passes + 1) / (checks + 2) / std::max(latency, 1.0);
+    }
+
+    /**
+     * \brief Counts a win for the function
+     */
+    void win() noexcept
+    {
+        if (Shard* shards = m_active.load(std::memory_order_acquire))
+        {
+            shards[thread_shard() % shard_count].wins.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * \brief Sums the latency histograms of the shards
+     */
+    LatencyHistogram latency() const
+    {
+        LatencyHistogram latency;
+        const Shard* shards = m_shards.load(std::memory_order_acquire);
+        if (!shards)
+        {
+            return latency;
+        }
+
+        std::array<uint64_t, LatencyHistogram::bucket_count> counts{};
+        for (size_t s = 0; s < shard_count; ++s)
+        {
+            for (size_t i = 0; i < counts.size(); ++i)
+            {
+                counts[i] += shards[s].buckets[i].load(std::memory_order_relaxed);
+            }
+        }
+        latency.merge(counts);
+        return latency;
+    }
+
+    /**
+     * \brief Sums the shards into a snapshot
+     */
+    FunctionStats snapshot(const std::string& name) const
+    {
+        FunctionStats stats;
+        stats.name = name;
+        const Shard* shards = m_shards.load(std::memory_order_acquire);
+        if (!shards)
+        {
+            return stats;
+        }
+
+        for (size_t s = 0; s < shard_count; ++s)
+        {
+            const Shard& shard = shards[s];
+            stats.completed += shard.completed.load(std::memory_order_relaxed);
+            stats.timed_out += shard.timed_out.load(std::memory_order_relaxed);
+            stats.failed += shard.failed.load(std::memory_order_relaxed);
+            stats.wins += shard.wins.load(std::memory_order_relaxed);
+        }
+        stats.latency = latency();
+        return stats;
+    }
+
+private:
+    static constexpr uint64_t observation_window = 256;
+
+    struct alignas(64) Shard
+    {
+        std::atomic<uint64_t> completed{0};
+        std::atomic<uint64_t> timed_out{0};
+        std::atomic<uint64_t> failed{0};
+        std::atomic<uint64_t> wins{0};
+        std::array<std::atomic<uint64_t>, LatencyHistogram::bucket_count> buckets{};
+    };
+
+    void finish(Shard* shards, std::chrono::steady_clock::time_point start, const Deadline& deadline, bool failed)
+    {
+        const auto now = std::chrono::steady_clock::now();
+        const auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(now - start);
+        if (m_timed.load(std::memory_order_relaxed))
+        {
+            // Moving average with weight 1/8 for the newest sample, seeded by the first one
+            const auto sample = static_cast<uint64_t>(std::max<int64_t>(latency.count(), 1));
+            const auto average = m_latency.load(std::memory_order_relaxed);
+            m_latency.store(average ? average - average / 8 + sample / 8 : sample, std::memory_order_relaxed);
+        }
+        if (!shards)
+        {
+            return;
+        }
+
+        Shard& shard = shards[thread_shard() % shard_count];
+        shard.buckets[LatencyHistogram::bucket_of(latency)].fetch_add(1, std::memory_order_relaxed);
+        if (failed)
+        {
+            shard.failed.fetch_add(1, std::memory_order_relaxed);
+        }
+        else if (deadline.is_set() && now > deadline.time())
+        {
+            shard.timed_out.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            shard.completed.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    std::unique_ptr<Shard[]> m_owner;
+    std::atomic<Shard*> m_shards{nullptr}; // Allocated shards, kept once recording has been enabled
+    std::atomic<Shard*> m_active{nullptr}; // Shards to record into, null while disabled
+    std::atomic<bool> m_timed{false};
+    std::atomic<uint64_t> m_latency{0}; // Average latency in nanoseconds, 0 until timed
+    std::atomic<uint64_t> m_checks{0};
+    std::atomic<uint64_t> m_passes{0};
+};
+} // namespace aux
+
+namespace aux
+{
+/**
+ * \brief Shared state of one batch execution over the (input x function) matrix
+ * 
+ * Work is split into chunks of consecutive inputs for a single function, so the functions of one
+ * input still run in parallel while each pool job amortizes scheduling over several inputs. The
+ * state and its jobs are a single allocation (plus the copied inputs) for the whole batch.
+ * 
+ * \tparam TaskType Type of the tasks
+ * \tparam Input Tuple of arguments for one input
+ */
+template<typename TaskType, typename Input>
+class Batch
+{
+public:
+    using result_type = typename TaskType::return_type;
+
+    /**
+     * \brief Starts a batch on a pool
+     * 
+     * \param pool Pool to run the chunks on
+     * \param tasks Functions to run, one column each
+     * \param inputs Argument tuples, one row each
+     * \param firstWins If true, a row closes at its first successful result and skips the rest
+     * \return std::shared_ptr<Batch> State to wait on, nullptr if there is no work
+     */
+    static std::shared_ptr<Batch> start(ThreadPool& pool,
+                                        TaskList<TaskType> tasks,
+                                        const std::vector<Input>& inputs,
+                                        bool firstWins)
+    {
+        if (tasks.empty() || inputs.empty())
+        {
+            return nullptr;
+        }
+
+        auto batch = std::make_shared<Batch>(std::move(tasks), inputs, firstWins);
+        const size_t rows = inputs.size();
+        const size_t cols = batch->m_tasks.size();
+
+        // Aim for a few jobs per pool thread
+        const size_t target = std::max<size_t>(pool.size() * 4 / cols, 1);
+        const size_t perChunk = (rows + std::min(target, rows) - 1) / std::min(target, rows);
+        batch->m_chunks.reserve(cols * ((rows + perChunk - 1) / perChunk));
+        for (size_t col = 0; col < cols; ++col)
+        {
+            for (size_t row = 0; row < rows; row += perChunk)
+            {
+                batch->m_chunks.emplace_back(*batch, col, row, std::min(row + perChunk, rows));
+            }
+        }
+
+        batch->m_pending.store(batch->m_chunks.size());
+        batch->m_self = batch;
+        for (auto& chunk : batch->m_chunks)
+        {
+            pool.submit(static_cast<Job*>(&chunk));
+        }
+        return batch;
+    }
+
+    Batch(TaskList<TaskType> tasks, const std::vector<Input>& inputs, bool firstWins)
+        : m_tasks(std::move(tasks)),
+          m_inputs(inputs),
+          m_firstWins(firstWins),
+          m_cells(inputs.size() * m_tasks.size()),
+          m_done(std::make_unique<std::atomic<bool>[]>(m_cells.size())),
+          m_winners(std::make_unique<std::atomic<int>[]>(inputs.size())),
+          m_remaining(std::make_unique<std::atomic<size_t>[]>(inputs.size())),
+          m_open(inputs.size())
+    {
+        for (size_t row = 0; row < inputs.size(); ++row)
+        {
+            m_winners[row].store(-1);
+            m_remaining[row].store(m_tasks.size());
+        }
+    }
+
+    /**
+     * \brief Waits until every row is closed or the deadline passes, then stops the remaining work
+     * 
+     * \param deadline Time limit
+     * \return bool False if the deadline passed first
+     */
+    bool wait(const Deadline& deadline)
+    {
+        bool closed = true;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            closed = aux::wait_helping(m_cv, lock, deadline, [this]() { return m_open.load() == 0; });
+        }
+        m_stop.store(true);
+        return closed;
+    }
+
+    /**
+     * \brief Takes the result of a finished cell
+     * 
+     * \return std::optional<result_type> Result, nullopt if the cell failed or has not finished
+     */
+    std::optional<result_type> take(size_t row, size_t col)
+    {
+        const size_t cell = row * m_tasks.size() + col;
+        if (!m_done[cell].load(std::memory_order_acquire))
+        {
+            return std::nullopt;
+        }
+        return std::move(m_cells[cell]);
+    }
+
+    /**
+     * \brief Column of the first successful result of a row, -1 if none (firstWins batches)
+     */
+    int winner(size_t row) const
+    {
+        return m_winners[row].load();
+    }
+
+    /**
+     * \brief Borrows the result of a finished cell
+     * 
+     * \return const result_type* Result, nullptr if the cell failed or has not finished
+     */
+    const result_type* peek(size_t row, size_t col) const
+    {
+        const size_t cell = row * m_tasks.size() + col;
+        return m_done[cell].load(std::memory_order_acquire) ? &*m_cells[cell] : nullptr;
+    }
+
+private:
+    /**
+     * \brief Pool job running one function over a range of inputs
+     */
+    class Chunk final : public Job
+    {
+    public:
+        Chunk(Batch& batch, size_t col, size_t first, size_t last)
+            : m_batch(batch), m_col(col), m_first(first), m_last(last)
+        {
+        }
+
+        void run() noexcept override
+        {
+            for (size_t row = m_first; row < m_last; ++row)
+            {
+                m_batch.run_cell(row, m_col);
+            }
+            m_batch.finish_chunk();
+        }
+
+        void cancel() noexcept override
+        {
+            for (size_t row = m_first; row < m_last; ++row)
+            {
+                m_batch.finish_cell(row, false, m_col);
+            }
+            m_batch.finish_chunk();
+        }
+
+    private:
+        Batch& m_batch;
+        size_t m_col;
+        size_t m_first;
+        size_t m_last;
+    };
+
+    void run_cell(size_t row, size_t col)
+    {
+        if (m_stop.load(std::memory_order_relaxed) || (m_firstWins && m_winners[row].load() >= 0))
+        {
+            finish_cell(row, false, col);
+            return;
+        }
+
+        const size_t cell = row * m_tasks.size() + col;
+        bool ok = false;
+        try
+        {
+            const auto& task = m_tasks[col];
+            m_cells[cell].emplace(std::apply([&task](const auto&...args) { return task.get(args...); }, m_inputs[row]));
+            m_done[cell].store(true, std::memory_order_release);
+            ok = true;
+        }
+        catch (...)
+        {
+        } // Failed cells stay empty
+        finish_cell(row, ok, col);
+    }
+
+    void finish_cell(size_t row, bool ok, size_t col)
+    {
+        int none = -1;
+        if (ok && m_firstWins && m_winners[row].compare_exchange_strong(none, static_cast<int>(col)))
+        {
+            close_row();
+        }
+        if (m_remaining[row].fetch_sub(1) == 1 && (!m_firstWins || m_winners[row].load() < 0))
+        {
+            close_row();
+        }
+    }
+
+    void close_row()
+    {
+        if (m_open.fetch_sub(1) == 1)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+            }
+            m_cv.notify_all();
+        }
+    }
+
+    void finish_chunk()
+    {
+        if (m_pending.fetch_sub(1) == 1)
+        {
+            // The last chunk drops the self-reference; the batch may be destroyed right here
+            auto self = std::move(m_self);
+        }
+    }
+
+    TaskList<TaskType> m_tasks;
+    std::vector<Input> m_inputs;
+    const bool m_firstWins;
+    std::vector<std::optional<result_type>> m_cells;
+    std::unique_ptr<std::atomic<bool>[]> m_done;
+    std::unique_ptr<std::atomic<int>[]> m_winners;
+    std::unique_ptr<std::atomic<size_t>[]> m_remaining;
+    std::atomic<size_t> m_open;
+    std::atomic<size_t> m_pending{0};
+    std::atomic<bool> m_stop{false};
+    std::vector<Chunk> m_chunks;
+    std::shared_ptr<Batch> m_self;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+};
+} // namespace aux
+
+/**
+ * \brief Results of one Worker::execute_stream call, yielded in the order the functions complete
+ * 
+ * Failed functions are skipped. Destroying the stream stops the functions that did not start.
+ * 
+ * \tparam Ret Result type of the functions
+ */
+template<typename Ret>
+class ResultStream
+{
+public:
+    using value_type = std::pair<std::string, Ret>;
+
+    ResultStream(std::shared_ptr<aux::Channel<Ret>> channel, std::shared_ptr<const std::vector<std::string>> names)
+        : m_channel(std::move(channel)), m_names(std::move(names))
+    {
+    }
+
+    ResultStream(ResultStream&&) noexcept = default;
+    ResultStream& operator=(ResultStream&&) noexcept = default;
+    ResultStream(const ResultStream&) = delete;
+    ResultStream& operator=(const ResultStream&) = delete;
+
+    ~ResultStream()
+    {
+        if (m_channel)
+        {
+            m_channel->close();
+        }
+    }
+
+    /**
+     * \brief Blocks until the next function completes
+     * 
+     * \return std::optional<value_type> Name and result, nullopt once every function finished or the deadline passed
+     */
+    std::optional<value_type> next()
+    {
+        auto item = m_channel->pop();
+        if (!item)
+        {
+            return std::nullopt;
+        }
+        return value_type((*m_names)[static_cast<size_t>(item->first)], std::move(item->second));
+    }
+
+private:
+    std::shared_ptr<aux::Channel<Ret>> m_channel;
+    std::shared_ptr<const std::vector<std::string>> m_names;
+};
+
+/**
+ * \brief Delay after which Worker::execute_hedged starts the next function
+ * 
+ * Either fixed, or a latency quantile of the function started last as recorded by the worker's
+ * statistics, so that backups only start for runs in its tail.
+ */
+class HedgeDelay
+{
+public:
+    /**
+     * \brief Fixed delay
+     */
+    template<typename Rep, typename Period>
+    HedgeDelay(std::chrono::duration<Rep, Period> delay)
+        : m_delay(std::chrono::duration_cast<std::chrono::nanoseconds>(delay))
+    {
+    }
+
+    /**
+     * \brief Delay derived from the recorded latency of each function
+     * 
+     * Requires Worker::enable_stats; functions without recorded runs use the fallback.
+     * 
+     * \param quantile Latency quantile (e.g., 0.95)
+     * \param fallback Delay used without recorded runs
+     */
+    static HedgeDelay quantile(double quantile, std::chrono::nanoseconds fallback)
+    {
+        HedgeDelay delay(fallback);
+        delay.m_quantile = quantile;
+        return delay;
+    }
+
+    /**
+     * \brief Delay for a function, reading its latency history only for quantile delays
+     * 
+     * \param latency Callable returning the LatencyHistogram of the function
+     */
+    template<typename Latency>
+    std::chrono::nanoseconds resolve(Latency&& latency) const
+    {
+        if (m_quantile > 0)
+        {
+            const LatencyHistogram history = latency();
+            if (history.count() > 0)
+            {
+                return history.percentile(m_quantile);
+            }
+        }
+        return m_delay;
+    }
+
+private:
+    std::chrono::nanoseconds m_delay;
+    double m_quantile = 0;
+};
+
+/**
+ * \brief Order in which Worker::execute_order_with checks the results of its functions
+ */
+enum class OrderMode
+{
+    Strict,  // Registration order
+    Adaptive // Functions likeliest to pass soonest first, learned from previous executions
+};
+
+/**
+ * \brief Manages and executes groups of tasks with various strategies
+ * 
+ * Registered functions form an immutable snapshot, rebuilt by add_function and shared by
+ * executions, so executing never copies the callables. Functions may be added, removed or
+ * replaced while other threads execute; executions read the current snapshot without locking.
+ * Per-function statistics are recorded once enable_stats is called and read with stats.
+ * 
+ * Each execution moves or copies its arguments once. An argument declared as a reference to a
+ * type that cannot be copied is borrowed instead, so an execution returning before all of its
+ * functions finished, on a deadline or early result, then also waits for the losing ones.
+ * 
+ * \tparam Ret Return type of the tasks
+ * \tparam Args Argument types for the tasks
+ */
+template<typename Ret, typename... Args>
+class Worker
+{
+public:
+    using TaskType = Task<Ret(aux::param_t<Args>...)>;
+    using ConditionType = std::function<bool(const Ret&)>;
+    using ComparatorType = std::function<bool(const Ret&, const Ret&)>;
+    using ReducerType = std::function<Ret(Ret, Ret)>;
+    using input_type = std::tuple<std::decay_t<Args>...>;
+
+    /**
+     * \brief Constructs a worker whose functions run on the global pool
+     */
+    Worker() = default;
+
+    /**
+     * \brief Constructs a worker whose functions run on the given pool
+     * 
+     * \param pool Pool to execute functions on, must outlive the worker
+     */
+    explicit Worker(ThreadPool& pool) : pool_(&pool)
+    {
+    }
+
+    Worker(const Worker&) = delete;
+    Worker& operator=(const Worker&) = delete;
+
+    /**
+     * \brief Adds a function to the worker
+     * 
+     * \param name Name identifier for the function
+     * \param fn Function to add
+     */
+    template<typename Fn>
+    void add_function(const std::string& name, Fn&& fn)
+    {
+        add_task(name, std::forward<Fn>(fn));
+    }
+
+    /**
+     * \brief Adds a member function to the worker
+     * 
+     * \tparam MemFn Member function type
+     * \tparam Obj Object type
+     * \param name Name identifier for the function
+     * \param mem_fn Pointer to member function
+     * \param obj Object instance to bind
+     */
+    template<typename MemFn, typename Obj>
+    void add_function(const std::string& name, MemFn mem_fn, Obj&& obj)
+    {
+        add_task(name, bind_member(mem_fn, std::forward<Obj>(obj)));
+    }
+
+    /**
+     * \brief Removes the first function registered under a name
+     * 
+     * Executions already running keep using the functions they started with.
+     * 
+     * \param name Name identifier for the function
+     * \return bool False if no function has that name
+     */
+    bool remove_function(const std::string& name)
+    {
+        return update(
+            [&name](Snapshot& next)
+            {
+                auto it = std::find(next.names.begin(), next.names.end(), name);
+                if (it == next.names.end())
+                {
+                    return false;
+                }
+                const auto index = it - next.names.begin();
+                next.tasks.erase(next.tasks.begin() + index);
+                next.recorders.erase(next.recorders.begin() + index);
+                next.names.erase(it);
+                return true;
+            });
+    }
+
+    /**
+     * \brief Replaces the first function registered under a name, keeping its position
+     * 
+     * \param name Name identifier for the function
+     * \param fn New function
+     * \return bool False if no function has that name
+     */
+    template<typename Fn>
+    bool replace_function(const std::string& name, Fn&& fn)
+    {
+        return replace_task(name, std::forward<Fn>(fn));
+    }
+
+    /**
+     * \brief Replaces the first function registered under a name with a member function
+     * 
+     * \tparam MemFn Member function type
+     * \tparam Obj Object type
+     * \param name Name identifier for the function
+     * \param mem_fn Pointer to member function
+     * \param obj Object instance to bind
+     * \return bool False if no function has that name
+     */
+    template<typename MemFn, typename Obj>
+    bool replace_function(const std::string& name, MemFn mem_fn, Obj&& obj)
+    {
+        return replace_task(name, bind_member(mem_fn, std::forward<Obj>(obj)));
+    }
+
+    /**
+     * \brief Marks the first function registered under a name as cheap enough to run on the calling thread
+     * 
+     * Executions dispatch the other functions to the pool first, then run inline functions
+     * themselves, saving them the trip through the pool.
+     * 
+     * \param name Name identifier for the function
+     * \param runs_inline Whether the function runs inline
+     * \return bool False if no function has that name
+     */
+    bool set_inline(const std::string& name, bool runs_inline = true)
+    {
+        return update(
+            [&](Snapshot& next)
+            {
+                auto it = std::find(next.names.begin(), next.names.end(), name);
+                if (it == next.names.end())
+                {
+                    return false;
+                }
+                auto& task = next.tasks[static_cast<size_t>(it - next.names.begin())];
+                task = task.inlined(runs_inline);
+                return true;
+            });
+    }
+
+    /**
+     * \brief Runs inline every function whose recorded latency is below a threshold, see set_inline
+     * 
+     * A function is inline when 90% of its recorded runs took at most the threshold; functions
+     * without recorded runs keep their setting. Requires enable_stats.
+     * 
+     * \param threshold Latency below which a function is cheaper to run on the calling thread
+     * \return size_t Number of functions running inline
+     */
+    size_t classify_inline(std::chrono::nanoseconds threshold)
+    {
+        size_t count = 0;
+        update(
+            [&](Snapshot& next)
+            {
+                for (size_t i = 0; i < next.tasks.size(); ++i)
+                {
+                    const auto latency = next.recorders[i]->latency();
+                    if (latency.count() > 0)
+                    {
+                        next.tasks[i] = next.tasks[i].inlined(latency.percentile(0.9) <= threshold);
+                    }
+                    count += next.tasks[i].is_inline() ? 1 : 0;
+                }
+                return true;
+            });
+        return count;
+    }
+
+    /**
+     * \brief Executes any task and returns the first completed result
+     * 
+     * Borrowed arguments (see Worker) make it wait for the losing functions as well.
+     * 
+     * \param args Arguments for the tasks
+     * \param deadline Time limit (a duration, an instant or none)
+     * \return std::optional<std::pair<std::string, Ret>> Name and result of completed task
+     */
+    std::optional<std::pair<std::string, Ret>> execute_any(
+        Args... args, Deadline deadline = Deadline())
+    {
+        const auto snapshot = acquire();
+        const Arguments arguments(std::forward<Args>(args)...);
+        if (snapshot->tasks.empty())
+        {
+            return std::nullopt;
+        }
+
+        auto any_task = Any(tasks_of(snapshot), deadline, arguments.pack());
+
+        try
+        {
+            auto [index, result_opt] = any_task.get();
+            if (index >= 0 && result_opt && static_cast<size_t>(index) < snapshot->tasks.size())
+            {
+                return win(*snapshot, static_cast<size_t>(index), std::move(*result_opt));
+            }
+            return std::nullopt;
+        }
+        catch (...)
+        {
+            return std::nullopt;
+        }
+    }
+
+    /**
+     * \brief Starts functions one after another in registration order and returns the first completed result
+     * 
+     * The next function starts when no result arrived within the delay, or once every started
+     * function failed; the first result stops the others. See HedgeDelay for quantile delays.
+     * 
+     * Borrowed arguments (see Worker) make it wait for the losing functions as well.
+     * 
+     * \param delay Fixed delay, or HedgeDelay::quantile
+     * \param args Arguments for the tasks
+     * \param deadline Time limit (a duration, an instant or none)
+     * \return std::optional<std::pair<std::string, Ret>> Name and result of completed task
+     */
+    std::optional<std::pair<std::string, Ret>> execute_hedged(
+        HedgeDelay delay, Args... args, Deadline deadline = Deadline())
+    {
+        const auto snapshot = acquire();
+        const Arguments arguments(std::forward<Args>(args)...);
+        if (snapshot->tasks.empty())
+        {
+            return std::nullopt;
+        }
+
+        auto delayOf = [&delay, &snapshot](size_t index)
+        { return delay.resolve([&]() { return snapshot->recorders[index]->latency(); }); };
+        try
+        {
+            auto [index, result_opt] = aux::getHedgedResultPair(
+                delayOf, tasks_of(snapshot), arguments.pack(), deadline);
+            if (index >= 0 && result_opt)
+            {
+                return win(*snapshot, static_cast<size_t>(index), std::move(*result_opt));
+            }
+        }
+        catch (...)
+        {
+            // No result
+        }
+        return std::nullopt;
+    }
+
+    /**
+     * \brief Executes tasks and returns the first successful results, once there are enough
+     * 
+     * Borrowed arguments (see Worker) make it wait for the losing functions as well.
+     * 
+     * \param quorum Number of results to wait for
+     * \param args Arguments for the tasks
+     * \param deadline Time limit (a duration, an instant or none)
+     * \return std::vector<std::pair<std::string, Ret>> Names and results in arrival order, fewer than
+     *         quorum if the functions failed or the deadline passed first
+     */
+    std::vector<std::pair<std::string, Ret>> execute_quorum(size_t quorum, Args... args, Deadline deadline = Deadline())
+    {
+        return execute_quorum_with(quorum, aux::AcceptAll(), std::forward<Args>(args)..., deadline);
+    }
+
+    /**
+     * \brief Executes tasks and returns the first results satisfying a condition, once there are enough
+     * 
+     * Borrowed arguments (see Worker) make it wait for the losing functions as well.
+     * 
+     * \param quorum Number of results to wait for
+     * \param condition Condition function, may be called concurrently from several threads
+     * \param args Arguments for the tasks
+     * \param deadline Time limit (a duration, an instant or none)
+     * \return std::vector<std::pair<std::string, Ret>> Names and results in arrival order, fewer than
+     *         quorum if the functions failed or the deadline passed first
+     */
+    std::vector<std::pair<std::string, Ret>> execute_quorum_with(
+        size_t quorum, ConditionType condition, Args... args, Deadline deadline = Deadline())
+    {
+        const auto snapshot = acquire();
+        const Arguments arguments(std::forward<Args>(args)...);
+        std::vector<std::pair<std::string, Ret>> results;
+        try
+        {
+            auto indexed = aux::getQuorumResults(quorum,
+                                                 std::move(condition),
+                                                 tasks_of(snapshot),
+                                                 arguments.pack(),
+                                                 deadline);
+            results.reserve(indexed.size());
+            for (auto& [index, value] : indexed)
+            {
+                results.push_back(win(*snapshot, static_cast<size_t>(index), std::move(value)));
+            }
+        }
+        catch (...)
+        {
+            results.clear();
+        }
+        return results;
+    }
+
+    /**
+     * \brief Executes tasks and returns the first result satisfying a condition
+     * 
+     * Borrowed arguments (see Worker) make it wait for the losing functions as well.
+     * 
+     * \param condition Condition function
+     * \param args Arguments for the tasks
+     * \param deadline Time limit (a duration, an instant or none)
+     * \return std::optional<std::pair<std::string, Ret>> Name and result of completed task
+     */
+    std::optional<std::pair<std::string, Ret>> execute_any_with(
+        ConditionType condition, Args... args, Deadline deadline = Deadline())
+    {
+        const auto snapshot = acquire();
+        const Arguments arguments(std::forward<Args>(args)...);
+        if (snapshot->tasks.empty())
+        {
+            return std::nullopt;
+        }
+
+        auto any_with_task = AnyWith(condition, tasks_of(snapshot), deadline, arguments.pack());
+
+        auto [index, result_opt] = any_with_task.get();
+        if (index >= 0 && result_opt && static_cast<size_t>(index) < snapshot->tasks.size())
+        {
+            return win(*snapshot, static_cast<size_t>(index), std::move(*result_opt));
+        }
+        return std::nullopt;
+    }
+
+    /**
+     * \brief Executes all tasks and returns their results
+     * 
+     * \param args Arguments for the tasks
+     * \param deadline Time limit (a duration, an instant or none)
+     * \return std::vector<std::pair<std::string, Ret>> Names and results of all tasks
+     */
+    std::vector<std::pair<std::string, Ret>> execute_all(
+        Args... args, Deadline deadline = Deadline())
+    {
+        std::vector<std::pair<std::string, Ret>> results;
+        const auto snapshot = acquire();
+        const Arguments arguments(std::forward<Args>(args)...);
+        if (snapshot->tasks.empty())
+        {
+            return results;
+        }
+
+        auto all_task = All(tasks_of(snapshot), deadline, arguments.pack());
+
+        try
+        {
+            auto task_results_opt = all_task.get();
+            if (task_results_opt)
+            {
+                auto& task_results = *task_results_opt;
+                for (size_t i = 0; i < task_results.size() && i < snapshot->tasks.size(); ++i)
+                {
+                    results.emplace_back(snapshot->names[i], std::move(task_results[i]));
+                }
+            }
+        }
+        catch (...)
+        {
+            // Return empty results on failure
+        }
+        return results;
+    }
+
+    /**
+     * \brief Executes all tasks and returns the outcome of each, keeping results that finished in time
+     * 
+     * \param args Arguments for the tasks
+     * \param deadline Time limit (a duration, an instant or none)
+     * \return std::vector<std::pair<std::string, Outcome<Ret>>> Name and outcome of every task, in registration order
+     */
+    std::vector<std::pair<std::string, Outcome<Ret>>> execute_all_partial(Args... args, Deadline deadline = Deadline())
+    {
+        std::vector<std::pair<std::string, Outcome<Ret>>> results;
+        const auto snapshot = acquire();
+        const Arguments arguments(std::forward<Args>(args)...);
+        if (snapshot->tasks.empty())
+        {
+            return results;
+        }
+
+        auto outcomes = AllPartial(tasks_of(snapshot), deadline, arguments.pack()).get();
+        results.reserve(outcomes.size());
+        for (size_t i = 0; i < outcomes.size(); ++i)
+        {
+            results.emplace_back(snapshot->names[i], std::move(outcomes[i]));
+        }
+        return results;
+    }
+
+    /**
+     * \brief Starts all tasks and returns their results as they complete
+     * 
+     * \param args Arguments for the tasks
+     * \param deadline Time limit (a duration, an instant or none), counted from this call
+     * \return ResultStream<Ret> Stream yielding name and result of each successful task in completion order
+     */
+    ResultStream<Ret> execute_stream(Args... args, Deadline deadline = Deadline())
+    {
+        static_assert(!borrows_args, "the stream outlives the call, so pass arguments that cannot be copied by value");
+        const auto snapshot = acquire();
+        auto channel = aux::make_pooled<aux::Channel<Ret>>(snapshot->tasks.size(), deadline);
+        aux::post_all(tasks_of(snapshot), aux::make_args(std::forward<Args>(args)...), channel);
+        // Aliasing pointer: the stream keeps the snapshot, and with it the names, alive
+        return ResultStream<Ret>(std::move(channel),
+                                 std::shared_ptr<const std::vector<std::string>>(snapshot, &snapshot->names));
+    }
+
+    /**
+     * \brief Executes all tasks and folds their results as they complete
+     * 
+     * \param init Initial value
+     * \param reducer Associative and commutative operation, may be called concurrently from several threads
+     * \param args Arguments for the tasks
+     * \param deadline Time limit (a duration, an instant or none)
+     * \return std::optional<Ret> Folded value (nullopt if any task failed or timed out)
+     */
+    std::optional<Ret> execute_reduce(Ret init, ReducerType reducer, Args... args, Deadline deadline = Deadline())
+    {
+        const auto snapshot = acquire();
+        const Arguments arguments(std::forward<Args>(args)...);
+        try
+        {
+            return aux::getReduceResult(std::move(init),
+                                        std::move(reducer),
+                                        tasks_of(snapshot),
+                                        arguments.pack(),
+                                        deadline);
+        }
+        catch (...)
+        {
+            return std::nullopt;
+        }
+    }
+
+    /**
+     * \brief Executes all tasks and returns the best result
+     * 
+     * \param comparator Comparator function
+     * \param args Arguments for the tasks
+     * \param deadline Time limit (a duration, an instant or none)
+     * \return std::optional<std::pair<std::string, Ret>> Name and result of best task
+     */
+    std::optional<std::pair<std::string, Ret>> execute_best(
+        ComparatorType comparator, Args... args, Deadline deadline = Deadline())
+    {
+        const auto snapshot = acquire();
+        const Arguments arguments(std::forward<Args>(args)...);
+        if (snapshot->tasks.empty())
+        {
+            return std::nullopt;
+        }
+
+        auto best_task = BestIndexed(comparator, tasks_of(snapshot), deadline, arguments.pack());
+
+        try
+        {
+            auto [index, result_opt] = best_task.get();
+            if (index >= 0 && result_opt && static_cast<size_t>(index) < snapshot->tasks.size())
+            {
+                return win(*snapshot, static_cast<size_t>(index), std::move(*result_opt));
+            }
+            return std::nullopt;
+        }
+        catch (...)
+        {
+            return std::nullopt;
+        }
+    }
+
+    /**
+     * \brief Executes all tasks and returns the k best results as a bounded heap fills
+     * 
+     * Failed tasks are skipped; past the deadline, the best results that arrived in time are returned.
+     * 
+     * \param k Number of results to return
+     * \param comparator Comparator function, returning true if its first argument is better
+     * \param args Arguments for the tasks
+     * \param deadline Time limit (a duration, an instant or none)
+     * \return std::vector<std::pair<std::string, Ret>> Names and results, best first (ties in registration order)
+     */
+    std::vector<std::pair<std::string, Ret>> execute_top_k(
+        size_t k, ComparatorType comparator, Args... args, Deadline deadline = Deadline())
+    {
+        const Arguments arguments(std::forward<Args>(args)...);
+        return top_k(k, std::move(comparator), std::nullopt, arguments.pack(), deadline);
+    }
+
+    /**
+     * \brief Like execute_top_k, stopping the remaining tasks once none of them can enter the top k
+     * 
+     * Borrowed arguments (see Worker) make it wait for the losing functions as well.
+     * 
+     * \param k Number of results to return
+     * \param comparator Comparator function, returning true if its first argument is better
+     * \param bound Value no result can beat, e.g. a lower bound on a cost
+     * \param args Arguments for the tasks
+     * \param deadline Time limit (a duration, an instant or none)
+     * \return std::vector<std::pair<std::string, Ret>> Names and results, best first (ties in registration order)
+     */
+    std::vector<std::pair<std::string, Ret>> execute_top_k_bounded(
+        size_t k, ComparatorType comparator, Ret bound, Args... args, Deadline deadline = Deadline())
+    {
+        const Arguments arguments(std::forward<Args>(args)...);
+        return top_k(k, std::move(comparator), std::move(bound), arguments.pack(), deadline);
+    }
+
+    /**
+     * \brief Executes tasks in order and returns the first result satisfying a condition
+     * 
+     * Borrowed arguments (see Worker) make it wait for the losing functions as well.
+     * 
+     * \param condition Condition function
+     * \param args Arguments for the tasks
+     * \param deadline Time limit (a duration, an instant or none)
+     * \return std::optional<std::pair<std::string, Ret>> Name and result of completed task
+     */
+    std::optional<std::pair<std::string, Ret>> execute_order_with(
+        ConditionType condition, Args... args, Deadline deadline = Deadline())
+    {
+        const auto snapshot = acquire();
+        const Arguments arguments(std::forward<Args>(args)...);
+        if (snapshot->tasks.empty())
+        {
+            return std::nullopt;
+        }
+
+        if (order_mode_.load(std::memory_order_relaxed) == OrderMode::Strict)
+        {
+            auto order_with_task = OrderWith(condition, tasks_of(snapshot), deadline, arguments.pack());
+
+            auto [index, result_opt] = order_with_task.get();
+            if (index >= 0 && result_opt && static_cast<size_t>(index) < snapshot->tasks.size())
+            {
+                return win(*snapshot, static_cast<size_t>(index), std::move(*result_opt));
+            }
+            return std::nullopt;
+        }
+
+        const auto order = adaptive_order(*snapshot);
+        auto ordered = std::make_shared<std::vector<TaskType>>();
+        ordered->reserve(order.size());
+        for (size_t index : order)
+        {
+            ordered->push_back(snapshot->tasks[index]);
+        }
+        auto order_with_task = OrderWith(
+            condition, aux::TaskList<TaskType>(std::move(ordered)), deadline, arguments.pack());
+
+        // Every function checked before the accepted one failed, by exception, condition or timeout
+        auto [position, result_opt] = order_with_task.get();
+        const size_t checked = position >= 0 ? static_cast<size_t>(position) : order.size();
+        for (size_t i = 0; i < checked && i < order.size(); ++i)
+        {
+            snapshot->recorders[order[i]]->observe(false);
+        }
+        if (position >= 0 && result_opt && checked < order.size())
+        {
+            const size_t index = order[checked];
+            snapshot->recorders[index]->observe(true);
+            return win(*snapshot, index, std::move(*result_opt));
+        }
+        return std::nullopt;
+    }
+
+    /**
+     * \brief Chooses the order in which execute_order_with checks results
+     * 
+     * In adaptive mode, results are checked in decreasing order of pass rate per latency, as
+     * observed by earlier executions; ties, including a fresh worker, keep registration order.
+     * The first result passing the condition in that order is returned, so results may come from
+     * a different function than in strict mode.
+     * 
+     * \param mode Strict (default) or adaptive
+     */
+    void set_order_mode(OrderMode mode)
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        order_mode_.store(mode, std::memory_order_relaxed);
+        for (const auto& recorder : owner_->recorders)
+        {
+            recorder->enable_timing(mode == OrderMode::Adaptive);
+        }
+    }
+
+    OrderMode order_mode() const noexcept
+    {
+        return order_mode_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * \brief Runs every function on every input and collects the results in a matrix
+     * 
+     * The (input x function) matrix is scheduled as chunks of inputs per function.
+     * 
+     * \param inputs Argument tuples, one per input
+     * \param deadline Time limit for the whole batch
+     * \return ResultMatrix<Ret> One row per input and one column per function (nullopt cells failed or timed out)
+     */
+    ResultMatrix<Ret> execute_all_batch(const std::vector<input_type>& inputs,
+                                        Deadline deadline = Deadline())
+    {
+        const auto snapshot = acquire();
+        ResultMatrix<Ret> results(inputs.size(), snapshot->names);
+        auto batch = BatchType::start(pool(), tasks_of(snapshot), inputs, false);
+        if (!batch)
+        {
+            return results;
+        }
+
+        batch->wait(deadline);
+        for (size_t row = 0; row < results.rows(); ++row)
+        {
+            for (size_t col = 0; col < results.cols(); ++col)
+            {
+                results(row, col) = batch->take(row, col);
+            }
+        }
+        return results;
+    }
+
+    /**
+     * \brief Runs the functions on every input and keeps the first completed result per input
+     * 
+     * Once an input has a result, its pending functions are skipped.
+     * 
+     * \param inputs Argument tuples, one per input
+     * \param deadline Time limit for the whole batch
+     * \return std::vector<std::optional<std::pair<std::string, Ret>>> Name and result per input
+     */
+    std::vector<std::optional<std::pair<std::string, Ret>>> execute_any_batch(
+        const std::vector<input_type>& inputs, Deadline deadline = Deadline())
+    {
+        const auto snapshot = acquire();
+        std::vector<std::optional<std::pair<std::string, Ret>>> results(inputs.size());
+        auto batch = BatchType::start(pool(), tasks_of(snapshot), inputs, true);
+        if (!batch)
+        {
+            return results;
+        }
+
+        batch->wait(deadline);
+        for (size_t row = 0; row < inputs.size(); ++row)
+        {
+            const int winner = batch->winner(row);
+            if (winner >= 0)
+            {
+                const auto col = static_cast<size_t>(winner);
+                results[row].emplace(win(*snapshot, col, std::move(*batch->take(row, col))));
+            }
+        }
+        return results;
+    }
+
+    /**
+     * \brief Runs every function on every input and keeps the best result per input
+     * 
+     * An input whose functions did not all succeed in time has no result.
+     * 
+     * \param comparator Comparator function, called on this thread
+     * \param inputs Argument tuples, one per input
+     * \param deadline Time limit for the whole batch
+     * \return std::vector<std::optional<std::pair<std::string, Ret>>> Name and best result per input
+     */
+    std::vector<std::optional<std::pair<std::string, Ret>>> execute_best_batch(
+        ComparatorType comparator,
+        const std::vector<input_type>& inputs,
+        Deadline deadline = Deadline())
+    {
+        const auto snapshot = acquire();
+        std::vector<std::optional<std::pair<std::string, Ret>>> results(inputs.size());
+        auto batch = BatchType::start(pool(), tasks_of(snapshot), inputs, false);
+        if (!batch)
+        {
+            return results;
+        }
+
+        batch->wait(deadline);
+        const size_t cols = snapshot->tasks.size();
+        for (size_t row = 0; row < inputs.size(); ++row)
+        {
+            try
+            {
+                // Ties go to the lower index, matching a scan in registration order
+                const Ret* best = nullptr;
+                size_t bestCol = 0;
+                size_t col = 0;
+                for (; col < cols; ++col)
+                {
+                    const Ret* value = batch->peek(row, col);
+                    if (!value)
+                    {
+                        break;
+                    }
+                    if (!best || comparator(*value, *best))
+                    {
+                        best = value;
+                        bestCol = col;
+                    }
+                }
+                if (col == cols)
+                {
+                    results[row].emplace(win(*snapshot, bestCol, std::move(*batch->take(row, bestCol))));
+                }
+            }
+            catch (...)
+            {
+                // Leave the input without a result
+            }
+        }
+        return results;
+    }
+
+    /**
+     * \brief Starts or stops recording per-function statistics, off by default
+     * 
+     * Recording covers latency, outcome and wins of each function; while it is off, running a
+     * function costs one extra atomic load.
+     * 
+     * \param enabled Whether to record
+     */
+    void enable_stats(bool enabled = true)
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        stats_enabled_ = enabled;
+        for (const auto& recorder : owner_->recorders)
+        {
+            recorder->enable(enabled);
+        }
+    }
+
+    /**
+     * \brief Statistics of every function, in registration order
+     * 
+     * A run counts as timed out when it finished after the deadline of its execution.
+     * Statistics survive replace_function and are dropped by remove_function.
+     * 
+     * \return std::vector<FunctionStats> One entry per function
+     */
+    std::vector<FunctionStats> stats() const
+    {
+        const auto snapshot = acquire();
+        std::vector<FunctionStats> result;
+        result.reserve(snapshot->names.size());
+        for (size_t i = 0; i < snapshot->names.size(); ++i)
+        {
+            result.push_back(snapshot->recorders[i]->snapshot(snapshot->names[i]));
+        }
+        return result;
+    }
+
+private:
+    /**
+     * \brief Immutable set of registered functions, shared by every execution started while it is current
+     */
+    struct Snapshot : std::enable_shared_from_this<Snapshot>
+    {
+        std::vector<std::string> names;
+        std::vector<TaskType> tasks;
+        std::vector<std::shared_ptr<aux::StatsRecorder>> recorders;
+    };
+
+    static aux::TaskList<TaskType> tasks_of(const std::shared_ptr<const Snapshot>& snapshot)
+    {
+        // Aliasing pointer: the task list keeps the whole snapshot alive
+        return aux::TaskList<TaskType>(std::shared_ptr<const std::vector<TaskType>>(snapshot, &snapshot->tasks));
+    }
+
+    using BatchType = aux::Batch<TaskType, input_type>;
+    using pack_type = aux::ArgPack<aux::stored_arg_t<Args>...>;
+
+    static constexpr bool borrows_args = (std::is_reference_v<aux::stored_arg_t<Args>> || ... || false);
+
+    /**
+     * \brief Arguments of one execution, moved or copied once into a pack shared by its tasks
+     * 
+     * A reference to an argument that cannot be copied is borrowed instead. The tasks then get a
+     * pack lent by the execution, whose deleter wakes the execution once the last task lets go of
+     * it, and the execution waits for that on leaving.
+     */
+    class Arguments
+    {
+    public:
+        explicit Arguments(Args... args) : pack_(std::in_place, std::forward<Args>(args)...)
+        {
+            if constexpr (borrows_args)
+            {
+                lent_.emplace(std::shared_ptr<const typename pack_type::tuple_type>(
+                    &pack_.values(), [this](const typename pack_type::tuple_type*) { release(); }));
+            }
+        }
+
+        Arguments(const Arguments&) = delete;
+        Arguments& operator=(const Arguments&) = delete;
+
+        ~Arguments()
+        {
+            if constexpr (borrows_args)
+            {
+                lent_.reset();
+                std::unique_lock<std::mutex> lock(mutex_);
+                aux::wait_helping(cv_, lock, Deadline(), [this]() { return released_; });
+            }
+        }
+
+        const pack_type& pack() const noexcept
+        {
+            if constexpr (borrows_args)
+            {
+                return *lent_;
+            }
+            else
+            {
+                return pack_;
+            }
+        }
+
+    private:
+        void release()
+        {
+            // Notify under the lock: the execution may leave as soon as it is released
+            std::lock_guard<std::mutex> lock(mutex_);
+            released_ = true;
+            cv_.notify_all();
+        }
+
+        pack_type pack_;
+        std::optional<pack_type> lent_;
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        bool released_ = false;
+    };
+
+    template<typename MemFn, typename Obj>
+    static auto bind_member(MemFn mem_fn, Obj&& obj)
+    {
+        return [mem_fn, obj = std::forward<Obj>(obj)](aux::param_t<Args>... args) -> Ret
+        { return (obj->*mem_fn)(args...); };
+    }
+
+    /**
+     * \brief Wraps a function in a task that reports to the function's statistics
+     */
+    template<typename Fn>
+    TaskType make_task(Fn&& fn, std::shared_ptr<aux::StatsRecorder> recorder)
+    {
+        // Only a stateful function makes the task stateful, and so copied for each run
+        if constexpr (aux::is_const_callable_v<std::decay_t<Fn>, aux::param_t<Args>...>)
+        {
+            return TaskType([fn = std::forward<Fn>(fn), recorder = std::move(recorder)](
+                                const StopToken& token, aux::param_t<Args>... args) -> Ret
+                            { return call_recorded(fn, *recorder, token, args...); },
+                            pool());
+        }
+        else
+        {
+            return TaskType([fn = std::forward<Fn>(fn), recorder = std::move(recorder)](
+                                const StopToken& token, aux::param_t<Args>... args) mutable -> Ret
+                            { return call_recorded(fn, *recorder, token, args...); },
+                            pool());
+        }
+    }
+
+    template<typename Fn>
+    static Ret call_recorded(Fn& fn, aux::StatsRecorder& recorder, const StopToken& token, aux::param_t<Args>... args)
+    {
+        return recorder.record(token,
+                               [&]() -> Ret
+                               {
+                                   if constexpr (std::is_invocable_r_v<Ret, Fn&, const StopToken&, aux::param_t<Args>...>)
+                                   {
+                                       return fn(token, args...);
+                                   }
+                                   else
+                                   {
+                                       return fn(args...);
+                                   }
+                               });
+    }
+
+    template<typename Fn>
+    void add_task(const std::string& name, Fn&& fn)
+    {
+        update(
+            [&](Snapshot& next)
+            {
+                auto recorder = std::make_shared<aux::StatsRecorder>();
+                recorder->enable(stats_enabled_);
+                recorder->enable_timing(order_mode_.load(std::memory_order_relaxed) == OrderMode::Adaptive);
+                next.tasks.push_back(make_task(std::forward<Fn>(fn), recorder));
+                next.names.push_back(name);
+                next.recorders.push_back(std::move(recorder));
+                return true;
+            });
+    }
+
+    template<typename Fn>
+    bool replace_task(const std::string& name, Fn&& fn)
+    {
+        return update(
+            [&](Snapshot& next)
+            {
+                auto it = std::find(next.names.begin(), next.names.end(), name);
+                if (it == next.names.end())
+                {
+                    return false;
+                }
+                // The replacement keeps the statistics recorded under the name
+                const auto index = static_cast<size_t>(it - next.names.begin());
+                next.tasks[index] =
+                    make_task(std::forward<Fn>(fn), next.recorders[index]).inlined(next.tasks[index].is_inline());
+                return true;
+            });
+    }
+
+    /**
+     * \brief Indices of the functions by decreasing score, stable for equal scores
+     */
+    static std::vector<size_t> adaptive_order(const Snapshot& snapshot)
+    {
+        const size_t count = snapshot.recorders.size();
+        std::vector<double> scores(count);
+        std::vector<size_t> order(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            scores[i] = snapshot.recorders[i]->score();
+            order[i] = i;
+        }
+        std::stable_sort(order.begin(), order.end(), [&scores](size_t a, size_t b) { return scores[a] > scores[b]; });
+        return order;
+    }
+
+    template<typename Pack>
+    std::vector<std::pair<std::string, Ret>> top_k(
+        size_t k, ComparatorType comparator, std::optional<Ret> bound, const Pack& pack, const Deadline& deadline)
+    {
+        const auto snapshot = acquire();
+        std::vector<std::pair<std::string, Ret>> results;
+        try
+        {
+            auto indexed =
+                aux::getTopKResults(k, std::move(comparator), std::move(bound), tasks_of(snapshot), pack, deadline);
+            results.reserve(indexed.size());
+            for (auto& [index, value] : indexed)
+            {
+                results.push_back(win(*snapshot, static_cast<size_t>(index), std::move(value)));
+            }
+        }
+        catch (...)
+        {
+            results.clear();
+        }
+        return results;
+    }
+
+    /**
+     * \brief Names a winning result and counts the win in the function's statistics
+     */
+    static std::pair<std::string, Ret> win(const Snapshot& snapshot, size_t index, Ret&& value)
+    {
+        snapshot.recorders[index]->win();
+        return {snapshot.names[index], std::move(value)};
+    }
+
+    /**
+     * \brief Takes shared ownership of the current snapshot without locking
+     * 
+     * The reader count of the current epoch keeps writers from releasing the snapshot
+     * between loading the pointer and taking ownership.
+     */
+    std::shared_ptr<const Snapshot> acquire() const
+    {
+        for (;;)
+        {
+            const size_t epoch = epoch_.load();
+            auto& readers = readers_[epoch & 1];
+            readers.fetch_add(1);
+            // A writer that flipped the epoch before seeing this count may already have freed its snapshot
+            if (epoch_.load() != epoch)
+            {
+                readers.fetch_sub(1);
+                continue;
+            }
+            auto snapshot = current_.load()->shared_from_this();
+            readers.fetch_sub(1);
+            return snapshot;
+        }
+    }
+
+    /**
+     * \brief Publishes a modified copy of the current snapshot
+     * 
+     * Writers are serialized. The previous snapshot is released once every reader that may
+     * have loaded it has taken ownership (or given up), and lives on in running executions.
+     * 
+     * \param modify Callable editing the copy, returning false to discard it
+     * \return bool Result of modify
+     */
+    template<typename Modify>
+    bool update(Modify&& modify)
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        auto next = std::make_shared<Snapshot>(*owner_);
+        if (!modify(*next))
+        {
+            return false;
+        }
+
+        std::shared_ptr<const Snapshot> previous = std::move(owner_);
+        owner_ = std::move(next);
+        current_.store(owner_.get());
+
+        // Readers arriving from now on see the new epoch and the new snapshot
+        auto& readers = readers_[epoch_.fetch_add(1) & 1];
+        while (readers.load() != 0)
+        {
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+    ThreadPool& pool() const
+    {
+        return pool_ ? *pool_ : ThreadPool::global();
+    }
+
+    std::shared_ptr<const Snapshot> owner_ = std::make_shared<const Snapshot>();
+    std::atomic<const Snapshot*> current_{owner_.get()};
+    mutable std::array<std::atomic<size_t>, 2> readers_{};
+    std::atomic<size_t> epoch_{0};
+    std::mutex write_mutex_;
+    bool stats_enabled_ = false;
+    std::atomic<OrderMode> order_mode_{OrderMode::Strict};
+    ThreadPool* pool_ = nullptr;
+};
+
+/**
+ * \brief Callable paired with a compile-time name, see make_worker
+ * 
+ * \tparam Fn Type of the callable
+ */
+template<typename Fn>
+struct Named
+{
+    std::string_view name;
+    Fn fn;
+};
+
+/**
+ * \brief Names a callable for registration in a StaticWorker
+ * 
+ * \param name Name identifier for the function
+ * \param fn Callable object
+ * \return Named<Fn> Named callable
+ */
+template<typename Fn>
+constexpr auto named(std::string_view name, Fn&& fn) -> Named<std::decay_t<Fn>>
+{
+    return Named<std::decay_t<Fn>>{name, std::forward<Fn>(fn)};
+}
+
+template<typename Signature, typename... Fns>
+class StaticWorker;
+
+/**
+ * \brief Worker over a set of functions fixed at compile time
+ * 
+ * The callables live in a std::tuple and are dispatched through fold expressions, without
+ * std::function. Per-execution state (arguments, results, pool jobs) is recycled between
+ * executions, so executions do not allocate once the worker is warm. Callables may be invoked
+ * concurrently and receive the arguments as const lvalues.
+ * 
+ * Losing functions of execute_any and friends may still be running when the call returns;
+ * the destructor waits for them.
+ * 
+ * \tparam Ret Return type of the tasks
+ * \tparam Args Argument types for the tasks
+ * \tparam Fns Types of the callables
+ */
+template<typename Ret, typename... Args, typename... Fns>
+class StaticWorker<Ret(Args...), Fns...>
+{
+    static constexpr size_t count = sizeof...(Fns);
+
+    static_assert((std::is_invocable_r_v<Ret, const Fns&, const std::decay_t<Args>&...> && ...),
+                  "every function must be callable with Args and return something convertible to Ret");
+
+public:
+    using name_type = std::string_view;
+
+    /**
+     * \brief Constructs a worker whose functions run on the global pool
+     * 
+     * \param fns Named functions
+     */
+    explicit StaticWorker(Named<Fns>... fns) : StaticWorker(ThreadPool::global(), std::move(fns)...)
+    {
+    }
+
+    /**
+     * \brief Constructs a worker whose functions run on the given pool
+     * 
+     * \param pool Pool to execute functions on, must outlive the worker
+     * \param fns Named functions
+     */
+    explicit StaticWorker(ThreadPool& pool, Named<Fns>... fns)
+        : names_{fns.name...}, fns_(std::move(fns.fn)...), pool_(&pool)
+    {
+    }
+
+    ~StaticWorker()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_.wait(lock, [this]() { return idle_count_ == executions_.size(); });
+    }
+
+    StaticWorker(const StaticWorker&) = delete;
+    StaticWorker& operator=(const StaticWorker&) = delete;
+
+    /**
+     * \brief Preallocates execution state so that up to the given number of overlapping executions never allocate
+     * 
+     * An execution overlaps the following ones until its losing functions have finished.
+     * 
+     * \param executions Number of execution states to keep
+     */
+    void reserve(size_t executions)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        executions_.reserve(executions);
+        while (executions_.size() < executions)
+        {
+            executions_.emplace_back(std::make_unique<Execution>(*this));
+            auto* exec = executions_.back().get();
+            exec->next_free = free_;
+            free_ = exec;
+            ++idle_count_;
+        }
+    }
+
+    /**
+     * \brief Names of the functions in registration order
+     */
+    const std::array<name_type, count>& names() const noexcept
+    {
+        return names_;
+    }
+
+    /**
+     * \brief Executes any task and returns the first completed result
+     * 
+     * \param args Arguments for the tasks
+     * \param deadline Time limit (a duration, an instant or none)
+     * \return std::optional<std::pair<name_type, Ret>> Name and result of completed task
+     */
+    std::optional<std::pair<name_type, Ret>> execute_any(
+        Args... args, Deadline deadline = Deadline())
+    {
+        return execute_any_with(aux::AcceptAll(), std::forward<Args>(args)..., deadline);
+    }
+
+    /**
+     * \brief Executes tasks and returns the first result satisfying a condition
+     * 
+     * \tparam Pred Type of condition function, only ever called on the calling thread
+     * \param condition Condition function
+     * \param args Arguments for the tasks
+     * \param deadline Time limit (a duration, an instant or none)
+     * \return std::optional<std::pair<name_type, Ret>> Name and result of completed task
+     */
+    template<typename Pred>
+    std::optional<std::pair<name_type, Ret>> execute_any_with(
+        Pred&& condition, Args... args, Deadline deadline = Deadline())
+    {
+        Scope exec(*this, std::forward<Args>(args)...);
+        const auto until = deadline.start();
+        for (size_t i = 0; i < count; ++i)
+        {
+            size_t index = 0;
+            if (!exec->next(index, until))
+            {
+                break;
+            }
+            if (exec->succeeded(index) && accepts(condition, exec->result(index)))
+            {
+                return std::make_pair(names_[index], std::move(exec->result(index)));
+            }
+        }
+        return std::nullopt;
+    }
+
+    /**
+     * \brief Executes all tasks and returns their results
+     * 
+     * \param args Arguments for the tasks
+     * \param deadline Time limit (a duration, an instant or none)
+     * \return std::optional<std::array<Ret, N>> Results in registration order (nullopt on failure)
+     */
+    std::optional<std::array<Ret, count>> execute_all(
+        Args... args, Deadline deadline = Deadline())
+    {
+        if constexpr (count == 0)
+        {
+            return std::array<Ret, count>{};
+        }
+        else
+        {
+            Scope exec(*this, std::forward<Args>(args)...);
+            const auto until = deadline.start();
+            for (size_t i = 0; i < count; ++i)
+            {
+                size_t index = 0;
+                if (!exec->next(index, until) || !exec->succeeded(index))
+                {
+                    return std::nullopt;
+                }
+            }
+            return collect(*exec, std::make_index_sequence<count>());
+        }
+    }
+
+    /**
+     * \brief Executes all tasks and returns the best result
+     * 
+     * \tparam Comp Type of comparator function, only ever called on the calling thread
+     * \param comparator Comparator function, returning true if its first argument is better
+     * \param args Arguments for the tasks
+     * \param deadline Time limit (a duration, an instant or none)
+     * \return std::optional<std::pair<name_type, Ret>> Name and result of best task
+     */
+    template<typename Comp>
+    std::optional<std::pair<name_type, Ret>> execute_best(
+        Comp&& comparator, Args... args, Deadline deadline = Deadline())
+    {
+        Scope exec(*this, std::forward<Args>(args)...);
+        const auto until = deadline.start();
+        size_t best = count;
+        for (size_t i = 0; i < count; ++i)
+        {
+            size_t index = 0;
+            if (!exec->next(index, until) || !exec->succeeded(index))
+            {
+                return std::nullopt;
+            }
+
+            // Ties go to the lower index, matching a scan in registration order
+            if (best == count || comparator(exec->result(index), exec->result(best)) ||
+                (!comparator(exec->result(best), exec->result(index)) && index < best))
+            {
+                best = index;
+            }
+        }
+
+        if (best == count)
+        {
+            return std::nullopt;
+        }
+        return std::make_pair(names_[best], std::move(exec->result(best)));
+    }
+
+    /**
+     * \brief Executes tasks in order and returns the first result satisfying a condition
+     * 
+     * \tparam Pred Type of condition function, only ever called on the calling thread
+     * \param condition Condition function
+     * \param args Arguments for the tasks
+     * \param deadline Time limit (a duration, an instant or none)
+     * \return std::optional<std::pair<name_type, Ret>> Name and result of completed task
+     */
+    template<typename Pred>
+    std::optional<std::pair<name_type, Ret>> execute_order_with(
+        Pred&& condition, Args... args, Deadline deadline = Deadline())
+    {
+        Scope exec(*this, std::forward<Args>(args)...);
+        const auto until = deadline.start();
+        for (size_t index = 0; index < count; ++index)
+        {
+            if (!exec->wait(index, until))
+            {
+                break;
+            }
+            if (exec->succeeded(index) && accepts(condition, exec->result(index)))
+            {
+                return std::make_pair(names_[index], std::move(exec->result(index)));
+            }
+        }
+        return std::nullopt;
+    }
+
+private:
+    using args_tuple = std::tuple<std::decay_t<Args>...>;
+
+    class Execution;
+
+    /**
+     * \brief Pool job running one function of an execution
+     */
+    class SlotJob final : public aux::Job
+    {
+    public:
+        void run() noexcept override
+        {
+            exec->run_slot(index);
+        }
+
+        void cancel() noexcept override
+        {
+            exec->publish(index, false);
+        }
+
+        Execution* exec = nullptr;
+        size_t index = 0;
+    };
+
+    /**
+     * \brief State of one execution, shared by the caller and the pool jobs
+     */
+    class Execution
+    {
+    public:
+        explicit Execution(StaticWorker& owner) : owner_(owner)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                jobs_[i].exec = this;
+                jobs_[i].index = i;
+            }
+        }
+
+        void start(Args... args)
+        {
+            args_.emplace(std::forward<Args>(args)...);
+            stop_.store(false);
+            published_.store(0);
+            consumed_ = 0;
+            for (size_t i = 0; i < count; ++i)
+            {
+                status_[i].store(pending);
+                order_[i].store(count);
+            }
+
+            refs_.store(count + 1);
+            for (auto& job : jobs_)
+            {
+                owner_.pool_->submit(static_cast<aux::Job*>(&job));
+            }
+        }
+
+        /**
+         * \brief Waits for the next function to finish, in completion order
+         */
+        bool next(size_t& index, const Deadline& deadline)
+        {
+            auto published = [this]() { return order_[consumed_].load(std::memory_order_acquire) != count; };
+            if (!wait_for(published, deadline))
+            {
+                return false;
+            }
+            index = order_[consumed_++].load(std::memory_order_relaxed);
+            return true;
+        }
+
+        /**
+         * \brief Waits for a specific function to finish
+         */
+        bool wait(size_t index, const Deadline& deadline)
+        {
+            return wait_for([this, index]() { return status_[index].load(std::memory_order_acquire) != pending; },
+                            deadline);
+        }
+
+        bool succeeded(size_t index) const
+        {
+            return status_[index].load(std::memory_order_acquire) == succeeded_state;
+        }
+
+        Ret& result(size_t index)
+        {
+            return *results_[index];
+        }
+
+        /**
+         * \brief Stops the remaining functions and drops the caller's reference
+         */
+        void finish()
+        {
+            stop_.store(true, std::memory_order_release);
+            if (published_.load() == count)
+            {
+                // The jobs are only left with their release, so hand the state straight to the next call
+                while (refs_.load(std::memory_order_acquire) != 1)
+                {
+                    std::this_thread::yield();
+                }
+            }
+            release();
+        }
+
+        void run_slot(size_t index)
+        {
+            dispatch(index, std::make_index_sequence<count>());
+        }
+
+        void publish(size_t index, bool succeeded)
+        {
+            status_[index].store(succeeded ? succeeded_state : failed_state, std::memory_order_release);
+            order_[published_.fetch_add(1)].store(index, std::memory_order_release);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+            }
+            cv_.notify_one();
+            release();
+        }
+
+    private:
+        static constexpr uint8_t pending = 0;
+        static constexpr uint8_t succeeded_state = 1;
+        static constexpr uint8_t failed_state = 2;
+
+        template<typename Pred>
+        bool wait_for(Pred pred, const Deadline& deadline)
+        {
+            if (pred())
+            {
+                return true;
+            }
+            std::unique_lock<std::mutex> lock(mutex_);
+            return aux::wait_helping(cv_, lock, deadline, pred);
+        }
+
+        template<size_t... I>
+        void dispatch(size_t index, std::index_sequence<I...>)
+        {
+            ((index == I ? invoke<I>() : void()), ...);
+        }
+
+        template<size_t I>
+        void invoke()
+        {
+            bool ok = false;
+            if (stop_.load(std::memory_order_acquire))
+            {
+                owner_.pool_->note_cancelled();
+            }
+            else
+            {
+                try
+                {
+                    const auto& fn = std::get<I>(owner_.fns_);
+                    results_[I].emplace(std::apply([&fn](const auto&...args) -> Ret { return fn(args...); }, *args_));
+                    ok = true;
+                }
+                catch (...)
+                {
+                } // Failed functions never win
+            }
+            publish(I, ok);
+        }
+
+        void release()
+        {
+            if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                // Drop arguments and unclaimed results now rather than on reuse
+                args_.reset();
+                for (auto& result : results_)
+                {
+                    result.reset();
+                }
+                owner_.recycle(this);
+            }
+        }
+
+    public:
+        Execution* next_free = nullptr; // Link in the owner's free list
+
+    private:
+        StaticWorker& owner_;
+        std::optional<args_tuple> args_;
+        std::array<std::optional<Ret>, count> results_;
+        std::array<std::atomic<uint8_t>, count> status_;
+        std::array<std::atomic<size_t>, count> order_;
+        std::array<SlotJob, count> jobs_;
+        std::atomic<size_t> published_{0};
+        std::atomic<size_t> refs_{0};
+        std::atomic<bool> stop_{false};
+        size_t consumed_ = 0;
+        std::mutex mutex_;
+        std::condition_variable cv_;
+    };
+
+    /**
+     * \brief Caller's handle on an execution, finishing it on scope exit
+     */
+    class Scope
+    {
+    public:
+        Scope(StaticWorker& owner, Args... args) : exec_(owner.acquire())
+        {
+            exec_->start(std::forward<Args>(args)...);
+        }
+
+        ~Scope()
+        {
+            exec_->finish();
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        Execution* operator->() const noexcept
+        {
+            return exec_;
+        }
+
+        Execution& operator*() const noexcept
+        {
+            return *exec_;
+        }
+
+    private:
+        Execution* exec_;
+    };
+
+    template<typename Pred>
+    static bool accepts(Pred& condition, const Ret& value)
+    {
+        try
+        {
+            return condition(value);
+        }
+        catch (...)
+        {
+            return false;
+        }
+    }
+
+    template<size_t... I>
+    static std::array<Ret, count> collect(Execution& exec, std::index_sequence<I...>)
+    {
+        return {std::move(exec.result(I))...};
+    }
+
+    Execution* acquire()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!free_)
+        {
+            executions_.emplace_back(std::make_unique<Execution>(*this));
+            return executions_.back().get();
+        }
+        auto* exec = free_;
+        free_ = exec->next_free;
+        --idle_count_;
+        return exec;
+    }
+
+    void recycle(Execution* exec)
+    {
+        // Notify under the lock: the destructor may run as soon as the last execution is back
+        std::lock_guard<std::mutex> lock(mutex_);
+        exec->next_free = free_;
+        free_ = exec;
+        ++idle_count_;
+        idle_.notify_all();
+    }
+
+    std::array<name_type, count> names_;
+    std::tuple<Fns...> fns_;
+    ThreadPool* pool_;
+
+    std::mutex mutex_;
+    std::condition_variable idle_;
+    std::vector<std::unique_ptr<Execution>> executions_;
+    Execution* free_ = nullptr;
+    size_t idle_count_ = 0;
+};
+
+/**
+ * \brief Creates a StaticWorker running on the global pool
+ * 
+ * \tparam Signature Function signature of the tasks (e.g., double(int))
+ * \param fns Named functions, see named()
+ * \return StaticWorker<Signature, Fns...> Worker over the functions
+ */
+template<typename Signature, typename... Fns>
+auto make_worker(Named<Fns>... fns) -> StaticWorker<Signature, Fns...>
+{
+    return StaticWorker<Signature, Fns...>(std::move(fns)...);
+}
+
+/**
+ * \brief Creates a StaticWorker running on the given pool
+ * 
+ * \tparam Signature Function signature of the tasks (e.g., double(int))
+ * \param pool Pool to execute functions on, must outlive the worker
+ * \param fns Named functions, see named()
+ * \return StaticWorker<Signature, Fns...> Worker over the functions
+ */
+template<typename Signature, typename... Fns>
+auto make_worker(ThreadPool& pool, Named<Fns>... fns) -> StaticWorker<Signature, Fns...>
+{
+    return StaticWorker<Signature, Fns...>(pool, std::move(fns)...);
+}
+
+#ifdef HYPARA_COROUTINES
+/**
+ * \brief Awaitable running a task on its pool, resuming the awaiting coroutine on the completing thread
+ * 
+ * No thread blocks while a leaf task runs. The tasks of All, Any and AnyWith are started directly and resume the
+ * coroutine from their completion slot, on the thread deciding the outcome or on the pool at the deadline, so no
+ * thread waits for them either. The body of other combinator tasks waits for its children on the pool thread running
+ * it, helping the pool meanwhile. Awaiting rethrows the exception of a failed task.
+ * 
+ * \tparam Ret Return type of the task
+ * \tparam Args Argument types of the task
+ */
+template<typename Ret, typename... Args>
+class TaskAwaiter
+{
+public:
+    TaskAwaiter(Task<Ret(Args...)> task, std::tuple<std::decay_t<Args>...> args, StopToken token)
+        : m_task(std::move(task)), m_args(std::move(args)), m_token(std::move(token))
+    {
+    }
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        // The awaiter lives in the suspended frame until the task resumes it, so the task borrows the arguments
+        m_task.post_borrowed(
+            [this, handle](Expected<Ret>&& outcome)
+            {
+                m_outcome.emplace(std::move(outcome));
+                handle.resume();
+            },
+            m_token,
+            m_args);
+    }
+
+    Ret await_resume()
+    {
+        return std::move(*m_outcome).value();
+    }
+
+private:
+    Task<Ret(Args...)> m_task;
+    std::tuple<std::decay_t<Args>...> m_args;
+    StopToken m_token;
+    std::optional<Expected<Ret>> m_outcome;
+};
+
+/**
+ * \brief Awaitable running a task with the given arguments, e.g. co_await awaitable(task, 1, 2)
+ * 
+ * The arguments are stored in the awaiter, so move-only ones can be moved in.
+ */
+template<typename Ret, typename... Args, typename... CallArgs>
+TaskAwaiter<Ret, Args...> awaitable(const Task<Ret(Args...)>& task, CallArgs&&...args)
+{
+    return TaskAwaiter<Ret, Args...>(task, std::tuple<std::decay_t<Args>...>(std::forward<CallArgs>(args)...), StopToken());
+}
+
+/**
+ * \brief Makes tasks without arguments, such as those returned by All or Any, directly awaitable
+ * 
+ * Only All, Any and AnyWith resume the coroutine without a thread waiting for their tasks, see TaskAwaiter.
+ */
+template<typename Ret>
+TaskAwaiter<Ret> operator co_await(const Task<Ret()>& task)
+{
+    return TaskAwaiter<Ret>(task, std::tuple<>(), StopToken());
+}
+
+template<typename T>
+class Co;
+
+namespace aux
+{
+/**
+ * \brief Promise state shared by Co<T> and Co<void>
+ */
+class CoPromiseBase
+{
+public:
+    struct FinalAwaiter
+    {
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+
+        template<typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+        {
+            CoPromiseBase& promise = handle.promise();
+            if (promise.m_continuation)
+            {
+                return promise.m_continuation;
+            }
+            // Notify under the lock: the waiter may destroy the frame as soon as it is released
+            std::lock_guard<std::mutex> lock(promise.m_latch->mutex);
+            promise.m_latch->done = true;
+            promise.m_latch->cv.notify_all();
+            return std::noop_coroutine();
+        }
+
+        void await_resume() const noexcept
+        {
+        }
+    };
+
+    struct Latch
+    {
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool done = false;
+    };
+
+    std::suspend_always initial_suspend() const noexcept
+    {
+        return {};
+    }
+
+    FinalAwaiter final_suspend() const noexcept
+    {
+        return {};
+    }
+
+    void unhandled_exception() noexcept
+    {
+        m_error = std::current_exception();
+    }
+
+    std::coroutine_handle<> m_continuation;
+    Latch* m_latch = nullptr;
+    std::exception_ptr m_error;
+};
+
+template<typename T>
+class CoPromise : public CoPromiseBase
+{
+public:
+    Co<T> get_return_object() noexcept;
+
+    template<typename Value>
+    void return_value(Value&& value)
+    {
+        m_value.emplace(std::forward<Value>(value));
+    }
+
+    T take()
+    {
+        if (m_error)
+        {
+            std::rethrow_exception(m_error);
+        }
+        return std::move(*m_value);
+    }
+
+private:
+    std::optional<T> m_value;
+};
+
+template<>
+class CoPromise<void> : public CoPromiseBase
+{
+public:
+    Co<void> get_return_object() noexcept;
+
+    void return_void() const noexcept
+    {
+    }
+
+    void take()
+    {
+        if (m_error)
+        {
+            std::rethrow_exception(m_error);
+        }
+    }
+};
+} // namespace aux
+
+/**
+ * \brief Lazily started coroutine producing a T, awaitable from other coroutines or waited on with get()
+ * 
+ * The body starts when awaited or waited on. Together with TaskAwaiter, chains of tasks written as
+ * coroutines suspend instead of blocking a thread while each task runs.
+ * 
+ * \tparam T Result type
+ */
+template<typename T>
+class Co
+{
+public:
+    using promise_type = aux::CoPromise<T>;
+    using handle_type = std::coroutine_handle<promise_type>;
+
+    explicit Co(handle_type handle) noexcept : m_handle(handle)
+    {
+    }
+
+    Co(Co&& other) noexcept : m_handle(std::exchange(other.m_handle, {}))
+    {
+    }
+
+    Co& operator=(Co&& other) noexcept
+    {
+        if (this != &other)
+        {
+            destroy();
+            m_handle = std::exchange(other.m_handle, {});
+        }
+        return *this;
+    }
+
+    Co(const Co&) = delete;
+    Co& operator=(const Co&) = delete;
+
+    ~Co()
+    {
+        destroy();
+    }
+
+    auto operator co_await() && noexcept
+    {
+        struct Awaiter
+        {
+            handle_type handle;
+
+            bool await_ready() const noexcept
+            {
+                return false;
+            }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+            {
+                handle.promise().m_continuation = awaiting;
+                return handle;
+            }
+
+            T await_resume()
+            {
+                return handle.promise().take();
+            }
+        };
+        return Awaiter{m_handle};
+    }
+
+    /**
+     * \brief Runs the coroutine and blocks until it finished
+     * 
+     * On a pool thread, the pool is helped meanwhile, so the tasks the coroutine awaits can run there.
+     * 
+     * \return T Result, rethrowing the exception the coroutine ended with
+     */
+    T get() &&
+    {
+        typename promise_type::Latch latch;
+        m_handle.promise().m_latch = &latch;
+        m_handle.resume();
+        {
+            std::unique_lock<std::mutex> lock(latch.mutex);
+            aux::wait_helping(latch.cv, lock, Deadline(), [&latch]() { return latch.done; });
+        }
+        return m_handle.promise().take();
+    }
+
+private:
+    void destroy() noexcept
+    {
+        if (m_handle)
+        {
+            m_handle.destroy();
+        }
+    }
+
+    handle_type m_handle;
+};
+
+template<typename T>
+Co<T> aux::CoPromise<T>::get_return_object() noexcept
+{
+    return Co<T>(Co<T>::handle_type::from_promise(*this));
+}
+
+inline Co<void> aux::CoPromise<void>::get_return_object() noexcept
+{
+    return Co<void>(Co<void>::handle_type::from_promise(*this));
+}
+#endif // HYPARA_COROUTINES
+} // namespace hyp
+
 #endif // !_HYPARA_HPP_
\ No newline at end of file
@@ -1,836 +1,2525 @@
-#include <hypara.hpp>
-#include <catch2/catch_all.hpp>
-#include <cmath>
-#include <iostream>
-#include <numeric>
-#include <thread>
-
-using namespace std::chrono_literals;
-
-inline double fast_task(int x)
-{
-    return std::pow(x, 2);
-}
-
-inline double slow_task(int x)
-{
-    std::this_thread::sleep_for(200ms);
-    return std::pow(x, 3);
-}
-
-inline double conditional_task(int x)
-{
-    if (x % 2 == 0)
-    {
-        std::this_thread::sleep_for(20ms);
-    }
-    return x;
-}
-
-struct TestClass
-{
-    double member_task(int x)
-    {
-        return std::pow(x, 1.5);
-    }
-
-    static double static_task(int x)
-    {
-        return std::pow(x, 0.5);
-    }
-};
-
-TEST_CASE("Task basic functionality", "[task]")
-{
-    SECTION("Run task with lambda")
-    {
-        hyp::Task<double(int)> task([](int x) -> double { return x * 2.0; });
-        auto fut = task.run(5);
-        REQUIRE(fut.get() == Catch::Approx(10.0));
-    }
-
-    SECTION("Task then chain")
-    {
-        hyp::Task<double(int)> task1([](int x) -> double { return x * 2.0; });
-        auto task2 = task1.then([](double x) { return x + 3.0; });
-        REQUIRE(task2.get(5) == Catch::Approx(13.0));
-    }
-
-    SECTION("Task with member function")
-    {
-        TestClass obj;
-        hyp::Task<double(int)> task([&obj](int x) -> double { return obj.member_task(x); });
-        REQUIRE(task.get(4) == Catch::Approx(8.0));
-    }
-}
-
-TEST_CASE("Worker functionality", "[Worker]")
-{
-    TestClass obj;
-    hyp::Worker<double, int> worker;
-
-    SECTION("Add different task types")
-    {
-        worker.add_function("func1", fast_task);
-        worker.add_function("func2", &TestClass::member_task, &obj);
-        worker.add_function("func3", &TestClass::static_task);
-        worker.add_function("func4", [](int x) { return x * 1.0; });
-        REQUIRE(worker.execute_all(4).size() == 4);
-    }
-
-    SECTION("Execute Any strategy")
-    {
-        worker.add_function("fast", fast_task);
-        worker.add_function("slow", slow_task);
-
-        auto start = std::chrono::steady_clock::now();
-        auto result = worker.execute_any(3);
-        auto duration = std::chrono::steady_clock::now() - start;
-        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
-
-        REQUIRE(result.has_value());
-        REQUIRE(result.value().second == Catch::Approx(9.0));
-        REQUIRE(ms < 50);
-    }
-
-    SECTION("Execute AnyWith strategy")
-    {
-        worker.add_function("func7", [](int x) { return x * 10; });
-        worker.add_function("func8", [](int x) { return x * 20; });
-        worker.add_function("func9", [](int x) { return x * 30; });
-
-        auto result = worker.execute_any_with([](double val) { return val > 250; }, 10);
-        REQUIRE(result.has_value());
-        REQUIRE(result.value().second == Catch::Approx(300.0));
-    }
-
-    SECTION("Execute All strategy")
-    {
-        worker.add_function("fast", fast_task);
-        worker.add_function("slow",
-                            [](int x)
-                            {
-                                std::this_thread::sleep_for(50ms);
-                                return x * 1.0;
-                            });
-        worker.add_function("conditional", conditional_task);
-
-        auto results = worker.execute_all(3, 100ms);
-        REQUIRE(results.size() == 3);
-    }
-
-    SECTION("Execute Best strategy")
-    {
-        worker.add_function("func13", [](int x) { return x * 1.0; });
-        worker.add_function("func14", [](int x) { return x * 2.0; });
-        worker.add_function("func15", [](int x) { return x * 3.0; });
-
-        auto result = worker.execute_best([](double a, double b) { return a < b; }, 5);
-        REQUIRE(result.has_value());
-        REQUIRE(result.value().second == Catch::Approx(5.0));
-    }
-
-    SECTION("Execute OrderWith strategy")
-    {
-        worker.add_function("func16", [](int x) { return x * 1.0; });
-        worker.add_function("func17", [](int x) { return x * 3.0; });
-        worker.add_function("func18", [](int x) { return x * 2.0; });
-
-        auto result = worker.execute_order_with([](double val) { return val > 12; }, 5);
-        REQUIRE(result.has_value());
-        REQUIRE(result.value().second == Catch::Approx(15.0));
-    }
-
-    SECTION("Execute OrderWith with timeout")
-    {
-        worker.add_function("func19",
-                            [](int)
-                            {
-                                std::this_thread::sleep_for(30ms);
-                                return 1.0;
-                            });
-        worker.add_function("func20",
-                            [](int)
-                            {
-                                std::this_thread::sleep_for(10ms);
-                                return 2.0;
-                            });
-
-        auto result = worker.execute_order_with([](double val) { return val > 0; }, 3, 40ms);
-        REQUIRE(result.has_value());
-    }
-
-    SECTION("AnyWith with no match")
-    {
-        worker.add_function("func21", [](int x) { return x * 1.0; });
-        worker.add_function("func22", [](int x) { return x * 2.0; });
-
-        auto result = worker.execute_any_with([](double val) { return val > 100; }, 10);
-        REQUIRE_FALSE(result.has_value());
-    }
-
-    SECTION("Empty worker handling")
-    {
-        REQUIRE_FALSE(worker.execute_any(5).has_value());
-        REQUIRE_FALSE(worker.execute_any_with([](double) { return true; }, 5).has_value());
-        REQUIRE(worker.execute_all(5).empty());
-        REQUIRE_FALSE(worker.execute_best([](double, double) { return true; }, 5).has_value());
-        REQUIRE_FALSE(worker.execute_order_with([](double) { return true; }, 5).has_value());
-    }
-}
-
-TEST_CASE("Composite tasks", "[composite]")
-{
-    SECTION("All composite task")
-    {
-        std::vector<hyp::Task<double(int)>> tasks;
-        tasks.emplace_back([](int x) { return x * 1.0; });
-        tasks.emplace_back([](int x) { return x * 2.0; });
-        tasks.emplace_back([](int x) { return x * 3.0; });
-
-        auto composite = hyp::All(tasks, 0ms, 5);
-        auto results_opt = composite.get();
-        REQUIRE(results_opt.has_value());
-        auto results = *results_opt;
-        REQUIRE(results.size() == 3);
-        REQUIRE(results[0] == Catch::Approx(5.0));
-        REQUIRE(results[1] == Catch::Approx(10.0));
-        REQUIRE(results[2] == Catch::Approx(15.0));
-    }
-
-    SECTION("Any composite task")
-    {
-        std::vector<hyp::Task<double(int)>> tasks;
-        tasks.emplace_back(
-            [](int)
-            {
-                std::this_thread::sleep_for(50ms);
-                return 1.0;
-            });
-        tasks.emplace_back([](int) { return 2.0; });
-
-        auto composite = hyp::Any(tasks, 0ms, 0);
-        auto [index, result_opt] = composite.get();
-        REQUIRE(index == 1);
-        REQUIRE(result_opt.value() == Catch::Approx(2.0));
-    }
-
-    SECTION("Best composite task")
-    {
-        std::vector<hyp::Task<double(int)>> tasks;
-        tasks.emplace_back([](int x) { return x * 3.0; });
-        tasks.emplace_back([](int x) { return x * 1.0; });
-        tasks.emplace_back([](int x) { return x * 2.0; });
-
-        auto composite = hyp::Best([](double a, double b) { return a < b; }, tasks, 0ms, 5);
-        auto result_opt = composite.get();
-        REQUIRE(result_opt.has_value());
-        REQUIRE(*result_opt == Catch::Approx(5.0));
-    }
-}
-
-TEST_CASE("Timeout handling", "[timeout]")
-{
-    hyp::Worker<double, int> worker;
-
-    SECTION("Any with timeout")
-    {
-        worker.add_function("func1",
-                            [](int)
-                            {
-                                std::this_thread::sleep_for(100ms);
-                                return 1.0;
-                            });
-        worker.add_function("func2", [](int) { return 2.0; });
-
-        auto result = worker.execute_any(0, 50ms);
-        REQUIRE(result.has_value());
-        REQUIRE(result.value().second == Catch::Approx(2.0));
-    }
-
-    SECTION("AnyWith with timeout")
-    {
-        worker.add_function("func3",
-                            [](int)
-                            {
-                                std::this_thread::sleep_for(20ms);
-                                return 10.0;
-                            });
-        worker.add_function("func4",
-                            [](int)
-                            {
-                                std::this_thread::sleep_for(60ms);
-                                return 20.0;
-                            });
-
-        auto result = worker.execute_any_with([](double val) { return val > 15; }, 3, 40ms);
-        REQUIRE_FALSE(result.has_value());
-    }
-
-    SECTION("All with partial results")
-    {
-        worker.add_function("func5",
-                            [](int x)
-                            {
-                                std::this_thread::sleep_for(10ms);
-                                return x * 1.0;
-                            });
-        worker.add_function("func6",
-                            [](int x)
-                            {
-                                std::this_thread::sleep_for(50ms);
-                                return x * 2.0;
-                            });
-        worker.add_function("func7",
-                            [](int x)
-                            {
-                                std::this_thread::sleep_for(100ms);
-                                return x * 3.0;
-                            });
-
-        auto results = worker.execute_all(5, 60ms);
-        REQUIRE(results.size() == 0); // All must be completed to be considered complete
-    }
-
-    SECTION("Best with partial results")
-    {
-        worker.add_function("func8",
-                            [](int x)
-                            {
-                                std::this_thread::sleep_for(10ms);
-                                return x * 3.0;
-                            });
-        worker.add_function("func9",
-                            [](int x)
-                            {
-                                std::this_thread::sleep_for(50ms);
-                                return x * 1.0;
-                            });
-        worker.add_function("func10",
-                            [](int x)
-                            {
-                                std::this_thread::sleep_for(100ms);
-                                return x * 2.0;
-                            });
-
-        auto result = worker.execute_best([](double a, double b) { return a < b; }, 5, 60ms);
-        REQUIRE_FALSE(result.has_value()); // Best must be completed to be considered complete
-    }
-}
-
-TEST_CASE("Performance testing", "[performance]")
-{
-    constexpr int TASK_COUNT = 100;
-    hyp::Worker<double, int> worker;
-
-    for (int i = 0; i < TASK_COUNT; i++)
-    {
-        worker.add_function("task_" + std::to_string(i), [i](int x) { return x * i; });
-    }
-
-    SECTION("Any strategy performance")
-    {
-        auto start = std::chrono::high_resolution_clock::now();
-        auto result = worker.execute_any(5);
-        auto duration = std::chrono::high_resolution_clock::now() - start;
-        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
-
-        REQUIRE(result.has_value());
-        std::cout << "Any strategy with " << TASK_COUNT << " tasks took " << ms << " ms\n";
-        REQUIRE(ms < 50);
-    }
-
-    SECTION("All strategy performance")
-    {
-        auto start = std::chrono::high_resolution_clock::now();
-        auto results = worker.execute_all(5);
-        auto duration = std::chrono::high_resolution_clock::now() - start;
-        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
-
-        REQUIRE(results.size() == TASK_COUNT);
-        std::cout << "All strategy with " << TASK_COUNT << " tasks took " << ms << " ms\n";
-    }
-}
-
-TEST_CASE("Boundary testing", "[boundary]")
-{
-    hyp::Worker<double, int> worker;
-
-    SECTION("Large number of tasks")
-    {
-        constexpr int TASK_COUNT = 1000;
-        for (int i = 0; i < TASK_COUNT; i++)
-        {
-            worker.add_function("task_" + std::to_string(i), [i](int x) { return x * i; });
-        }
-
-        auto results = worker.execute_all(5);
-        REQUIRE(results.size() == TASK_COUNT);
-    }
-
-    SECTION("Long running tasks of any")
-    {
-        worker.add_function("long_task1",
-                            [](int)
-                            {
-                                std::this_thread::sleep_for(2s);
-                                return 1.0;
-                            });
-        worker.add_function("long_task2",
-                            [](int)
-                            {
-                                std::this_thread::sleep_for(2s);
-                                return 2.0;
-                            });
-
-        auto start = std::chrono::steady_clock::now();
-        auto result = worker.execute_any(0, 100ms);
-        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
-
-        REQUIRE_FALSE(result.has_value());
-        REQUIRE(duration < 300ms);
-    }
-
-    SECTION("Long running tasks of all")
-    {
-        worker.add_function("long_task3",
-                            [](int)
-                            {
-                                std::this_thread::sleep_for(2s);
-                                return 1.0;
-                            });
-        worker.add_function("long_task4",
-                            [](int)
-                            {
-                                std::this_thread::sleep_for(2s);
-                                return 2.0;
-                            });
-
-        auto start = std::chrono::steady_clock::now();
-        auto result = worker.execute_all(0, 100ms);
-        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
-
-        REQUIRE(result.empty());
-        REQUIRE(duration < 150ms);
-    }
-}
-
-TEST_CASE("Task exception handling", "[task]")
-{
-    SECTION("Task with exception in run")
-    {
-        hyp::Task<double(int)> task(
-            [](int x) -> double
-            {
-                if (x == 0)
-                {
-                    throw std::runtime_error("error");
-                }
-                return x * 1.0;
-            });
-
-        auto fut = task.run(0);
-        REQUIRE_THROWS_AS(fut.get(), std::runtime_error);
-    }
-
-    SECTION("Task with exception in then chain")
-    {
-        hyp::Task<double(int)> task1([](int x) -> double { return x * 2.0; });
-        auto task2 = task1.then(
-            [](double x)
-            {
-                if (x > 10)
-                {
-                    throw std::overflow_error("overflow");
-                }
-                return x;
-            });
-
-        REQUIRE_NOTHROW(task2.get(5));
-        REQUIRE_THROWS_AS(task2.get(10), std::overflow_error);
-    }
-}
-
-TEST_CASE("Worker exception handling", "[Worker]")
-{
-    hyp::Worker<double, int> worker;
-
-    SECTION("All with exception")
-    {
-        worker.add_function("good", [](int x) { return x * 1.0; });
-        worker.add_function("bad", [](int) -> double { throw std::logic_error("bad task"); });
-
-        auto results = worker.execute_all(5);
-        REQUIRE(results.size() == 0);
-    }
-
-    SECTION("Any with exception")
-    {
-        worker.add_function("fast", [](int) -> double { throw std::runtime_error("fast error"); });
-        worker.add_function("slow",
-                            [](int x)
-                            {
-                                std::this_thread::sleep_for(50ms);
-                                return x * 1.0;
-                            });
-
-        auto result = worker.execute_any(5, 100ms);
-        REQUIRE(result.has_value());
-        REQUIRE(result.value().second == Catch::Approx(5.0));
-    }
-}
-
-TEST_CASE("Composite AnyWith", "[composite]")
-{
-    SECTION("AnyWith composite task")
-    {
-        std::vector<hyp::Task<double(int)>> tasks;
-        tasks.emplace_back(
-            [](int x)
-            {
-                std::this_thread::sleep_for(50ms);
-                return x * 1.0;
-            });
-        tasks.emplace_back(
-            [](int x)
-            {
-                std::this_thread::sleep_for(10ms);
-                return x * 3.0;
-            });
-        tasks.emplace_back(
-            [](int x)
-            {
-                std::this_thread::sleep_for(30ms);
-                return x * 4.0;
-            });
-
-        auto composite = hyp::AnyWith([](double val) { return val > 25; }, tasks, 100ms, 10);
-        auto [index, result_opt] = composite.get();
-
-        REQUIRE(index == 1);
-        REQUIRE(result_opt.value() == Catch::Approx(30.0));
-    }
-
-    SECTION("AnyWith no match")
-    {
-        std::vector<hyp::Task<double(int)>> tasks;
-        tasks.emplace_back([](int x) { return x * 1.0; });
-        tasks.emplace_back([](int x) { return x * 2.0; });
-
-        auto composite = hyp::AnyWith([](double val) { return val > 100; }, tasks, 100ms, 10);
-        auto [index, result_opt] = composite.get();
-
-        REQUIRE(index == -1);
-        REQUIRE_FALSE(result_opt.has_value());
-    }
-}
-
-TEST_CASE("Composite OrderWith", "[composite]")
-{
-    SECTION("OrderWith composite task")
-    {
-        std::vector<hyp::Task<double(int)>> tasks;
-        tasks.emplace_back(
-            [](int x)
-            {
-                std::this_thread::sleep_for(50ms);
-                return x * 1.0; // 10.0
-            });
-        tasks.emplace_back(
-            [](int x)
-            {
-                std::this_thread::sleep_for(10ms);
-                return x * 2.0; // 20.0
-            });
-        tasks.emplace_back(
-            [](int x)
-            {
-                std::this_thread::sleep_for(30ms);
-                return x * 3.0; // 30.0
-            });
-
-        auto composite = hyp::OrderWith([](double val) { return val > 25; }, tasks, 300ms, 10);
-        auto [index, result_opt] = composite.get();
-
-        REQUIRE(index == 2);
-        REQUIRE(result_opt.value() == Catch::Approx(30.0));
-    }
-
-    SECTION("OrderWith timeout")
-    {
-        std::vector<hyp::Task<double(int)>> tasks;
-        tasks.emplace_back(
-            [](int x)
-            {
-                std::this_thread::sleep_for(100ms);
-                return x * 1.0;
-            });
-        tasks.emplace_back(
-            [](int x)
-            {
-                std::this_thread::sleep_for(200ms);
-                return x * 2.0;
-            });
-
-        auto composite = hyp::OrderWith([](double) { return true; }, tasks, 50ms, 10);
-        auto [index, result_opt] = composite.get();
-
-        REQUIRE(index == -1);
-        REQUIRE_FALSE(result_opt.has_value());
-    }
-}
-
-TEST_CASE("Task combinations", "[combo]")
-{
-    SECTION("All + then")
-    {
-        std::vector<hyp::Task<double(int)>> tasks;
-        tasks.emplace_back([](int x) { return x * 1.0; });
-        tasks.emplace_back([](int x) { return x * 2.0; });
-
-        auto all_task = hyp::All(tasks, 0ms, 5);
-        auto sum_task = all_task.then(
-            [](std::optional<std::vector<double>> results_opt)
-            {
-                REQUIRE(results_opt.has_value());
-                auto& results = *results_opt;
-                return std::accumulate(results.begin(), results.end(), 0.0);
-            });
-
-        REQUIRE(sum_task.get() == Catch::Approx(15.0));
-    }
-
-    SECTION("Any + then")
-    {
-        std::vector<hyp::Task<double(int)>> tasks;
-        tasks.emplace_back(
-            [](int x)
-            {
-                std::this_thread::sleep_for(50ms);
-                return x * 1.0;
-            });
-        tasks.emplace_back([](int x) { return x * 2.0; });
-
-        auto any_task = hyp::Any(tasks, 0ms, 5);
-        auto process_task = any_task.then(
-            [](auto pair)
-            {
-                REQUIRE(pair.first >= 0);
-                return pair.second.value() * 10;
-            });
-
-        REQUIRE(process_task.get() == Catch::Approx(100.0));
-    }
-}
-
-TEST_CASE("Worker boundary cases", "[Worker]")
-{
-    hyp::Worker<double, int> worker;
-
-    SECTION("Single task Any")
-    {
-        worker.add_function("single", [](int x) { return x * 1.0; });
-        auto result = worker.execute_any(5);
-        REQUIRE(result.has_value());
-        REQUIRE(result.value().second == Catch::Approx(5.0));
-    }
-
-    SECTION("Single task All")
-    {
-        worker.add_function("single", [](int x) { return x * 1.0; });
-        auto results = worker.execute_all(5);
-        REQUIRE(results.size() == 1);
-        REQUIRE(results[0].second == Catch::Approx(5.0));
-    }
-
-    SECTION("Single task AnyWith")
-    {
-        worker.add_function("single", [](int x) { return x * 1.0; });
-        auto result = worker.execute_any_with([](double v) { return v > 0; }, 5);
-        REQUIRE(result.has_value());
-        REQUIRE(result.value().second == Catch::Approx(5.0));
-    }
-
-    SECTION("Single task OrderWith")
-    {
-        worker.add_function("single",
-                            [](int x)
-                            {
-                                std::this_thread::sleep_for(10ms);
-                                return x * 1.0;
-                            });
-        auto result = worker.execute_order_with([](double v) { return v > 0; }, 5);
-        REQUIRE(result.has_value());
-        REQUIRE(result.value().second == Catch::Approx(5.0));
-    }
-}
-
-TEST_CASE("Extreme timeouts", "[timeout]")
-{
-    hyp::Worker<double, int> worker;
-    worker.add_function("fast", [](int x) { return x * 1.0; });
-    worker.add_function("slow",
-                        [](int x)
-                        {
-                            std::this_thread::sleep_for(100ms);
-                            return x * 2.0;
-                        });
-
-    SECTION("Zero timeout")
-    {
-        auto start = std::chrono::steady_clock::now();
-        auto results = worker.execute_all(5, 0ms);
-        auto duration = std::chrono::steady_clock::now() - start;
-
-        REQUIRE(duration >= 100ms);
-        REQUIRE(results.size() == 2);
-    }
-
-    SECTION("Large timeout")
-    {
-        auto start = std::chrono::steady_clock::now();
-        auto results = worker.execute_all(5, 500ms);
-        auto duration = std::chrono::steady_clock::now() - start;
-
-        REQUIRE(duration < 500ms);
-        REQUIRE(results.size() == 2);
-    }
-
-    SECTION("Exact timeout")
-    {
-        worker.add_function("exact",
-                            [](int x)
-                            {
-                                std::this_thread::sleep_for(50ms);
-                                return x * 3.0;
-                            });
-
-        auto start = std::chrono::steady_clock::now();
-        auto results = worker.execute_all(5, 50ms);
-        auto duration = std::chrono::steady_clock::now() - start;
-
-        REQUIRE(duration >= 50ms);
-        REQUIRE(results.size() == 0);
-    }
-}
-
-TEST_CASE("Combination strategies", "[combo]")
-{
-    hyp::Worker<double, int> worker;
-    worker.add_function("task1", [](int x) { return x * 1.0; });
-    worker.add_function("task2", [](int x) { return x * 2.0; });
-    worker.add_function("task3", [](int x) { return x * 3.0; });
-
-    SECTION("Any + Best")
-    {
-        auto any_result = worker.execute_any(5);
-        REQUIRE(any_result.has_value());
-
-        auto best_result = worker.execute_best([](double a, double b) { return a < b; }, 5);
-        REQUIRE(best_result.has_value());
-        REQUIRE(best_result.value().second == Catch::Approx(5.0));
-    }
-
-    SECTION("OrderWith + then")
-    {
-        auto order_result = worker.execute_order_with([](double v) { return v > 10; }, 5);
-        REQUIRE(order_result.has_value());
-
-        hyp::Task<double()> task([res = order_result.value().second]() -> double { return res * 2; });
-        REQUIRE(task.get() == Catch::Approx(30.0));
-    }
-}
-
-TEST_CASE("OrderWith boundary cases", "[Worker]")
-{
-    hyp::Worker<double, int> worker;
-
-    SECTION("No tasks")
-    {
-        auto result = worker.execute_order_with([](double) { return true; }, 5);
-        REQUIRE_FALSE(result.has_value());
-    }
-
-    SECTION("Single task immediate")
-    {
-        worker.add_function("task1", [](int x) { return x * 1.0; });
-        auto result = worker.execute_order_with([](double v) { return v > 0; }, 5);
-        REQUIRE(result.has_value());
-        REQUIRE(result->first == "task1");
-        REQUIRE(result->second == 5.0);
-    }
-
-    SECTION("Single task delayed")
-    {
-        worker.add_function("task1",
-                            [](int x)
-                            {
-                                std::this_thread::sleep_for(10ms);
-                                return x * 1.0;
-                            });
-        auto result = worker.execute_order_with([](double v) { return v > 0; }, 5);
-        REQUIRE(result.has_value());
-        REQUIRE(result->first == "task1");
-        REQUIRE(result->second == 5.0);
-    }
-
-    SECTION("Order of execution respected")
-    {
-        worker.add_function("task1",
-                            [](int x)
-                            {
-                                std::this_thread::sleep_for(30ms);
-                                return x * 1.0; // 5.0
-                            });
-        worker.add_function("task2",
-                            [](int x)
-                            {
-                                std::this_thread::sleep_for(10ms);
-                                return x * 2.0; // 10.0
-                            });
-        worker.add_function("task3",
-                            [](int x)
-                            {
-                                std::this_thread::sleep_for(20ms);
-                                return x * 3.0; // 15.0
-                            });
-
-        // Should find task2 first even though it completes earliest
-        auto result = worker.execute_order_with([](double v) { return v > 8; }, 5);
-
-        REQUIRE(result.has_value());
-        REQUIRE(result->first == "task2");
-        REQUIRE(result->second == 10.0);
-    }
-}
-
-TEST_CASE("All/Best timeout handling", "[timeout]")
-{
-    hyp::Worker<double, int> worker;
-
-    worker.add_function("fast",
-                        [](int x)
-                        {
-                            std::this_thread::sleep_for(10ms);
-                            return x * 1.0;
-                        });
-    worker.add_function("slow",
-                        [](int x)
-                        {
-                            std::this_thread::sleep_for(100ms);
-                            return x * 2.0;
-                        });
-
-    SECTION("All timeout")
-    {
-        auto results = worker.execute_all(5, 50ms);
-        REQUIRE(results.size() == 0);
-    }
-
-    SECTION("Best timeout")
-    {
-        auto result = worker.execute_best([](double a, double b) { return a < b; }, 5, 50ms);
-
-        REQUIRE_FALSE(result.has_value());
-    }
-}
\ No newline at end of file
+#include <hypara.hpp>
+#include <catch2/catch_all.hpp>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <numeric>
+#include <set>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+// Counts heap allocations made by threads that opted in via count_allocations
+static std::atomic<size_t> g_allocations{0};
+static thread_local bool t_countAllocations = false;
+
+void* operator new(std::size_t size)
+{
+    if (t_countAllocations)
+    {
+        ++g_allocations;
+    }
+    if (void* ptr = std::malloc(size == 0 ? 1 : size))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete" // operator new above is malloc-backed
+#endif
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+inline double fast_task(int x)
+{
+    return std::pow(x, 2);
+}
+
+inline double slow_task(int x)
+{
+    std::this_thread::sleep_for(200ms);
+    return std::pow(x, 3);
+}
+
+inline double conditional_task(int x)
+{
+    if (x % 2 == 0)
+    {
+        std::this_thread::sleep_for(20ms);
+    }
+    return x;
+}
+
+// Large argument counting its copies
+struct CountedBuffer
+{
+    explicit CountedBuffer(size_t size) : data(size, 1.0f)
+    {
+    }
+
+    CountedBuffer(const CountedBuffer& other) : data(other.data)
+    {
+        ++copies;
+    }
+
+    CountedBuffer(CountedBuffer&&) noexcept = default;
+    CountedBuffer& operator=(const CountedBuffer&) = delete;
+    CountedBuffer& operator=(CountedBuffer&&) = delete;
+
+    std::vector<float> data;
+    static std::atomic<int> copies;
+};
+
+std::atomic<int> CountedBuffer::copies{0};
+
+struct TestClass
+{
+    double member_task(int x)
+    {
+        return std::pow(x, 1.5);
+    }
+
+    static double static_task(int x)
+    {
+        return std::pow(x, 0.5);
+    }
+};
+
+TEST_CASE("Task basic functionality", "[task]")
+{
+    SECTION("Run task with lambda")
+    {
+        hyp::Task<double(int)> task([](int x) -> double { return x * 2.0; });
+        auto fut = task.run(5);
+        REQUIRE(fut.get() == Catch::Approx(10.0));
+    }
+
+    SECTION("Spawn with lightweight future")
+    {
+        hyp::Task<double(int)> task([](int x) -> double { return x * 2.0; });
+        auto fut = task.spawn(hyp::StopToken(), 5);
+        auto copy = fut;
+        REQUIRE(fut.get() == Catch::Approx(10.0));
+        REQUIRE(copy.wait_for(0s) == std::future_status::ready);
+
+        hyp::Task<void(int)> slow(
+            [](int x)
+            {
+                std::this_thread::sleep_for(20ms);
+                if (x < 0)
+                {
+                    throw std::invalid_argument("negative");
+                }
+            });
+        auto failing = slow.spawn(hyp::StopToken(), -1);
+        REQUIRE(failing.wait_for(1ms) == std::future_status::timeout);
+        REQUIRE_THROWS_AS(failing.get(), std::invalid_argument);
+        REQUIRE_NOTHROW(slow.spawn(hyp::StopToken(), 1).get());
+
+        hyp::StopSource stop;
+        stop.request_stop();
+        REQUIRE_THROWS_AS(task.spawn(stop.get_token(), 1).get(), hyp::TaskCancelled);
+    }
+
+    SECTION("Move-only arguments are moved into the run")
+    {
+        hyp::Task<int(std::unique_ptr<int>)> task([](std::unique_ptr<int> value) { return *value; });
+        REQUIRE(task.run(std::make_unique<int>(3)).get() == 3);
+        REQUIRE(task.spawn(hyp::StopToken(), std::make_unique<int>(4)).get() == 4);
+        REQUIRE(task.get(std::make_unique<int>(5)) == 5);
+
+        std::promise<int> posted;
+        task.post([&posted](hyp::Expected<int>&& outcome) { posted.set_value(outcome.value()); },
+                  std::make_unique<int>(6));
+        REQUIRE(posted.get_future().get() == 6);
+    }
+
+    SECTION("Stateful callables start fresh on every run")
+    {
+        hyp::Task<int()> counter([n = 0]() mutable { return n += 1000; });
+        std::vector<std::shared_future<int>> runs;
+        for (int i = 0; i < 8; ++i)
+        {
+            runs.push_back(counter.run());
+        }
+        for (auto& run : runs)
+        {
+            REQUIRE(run.get() == 1000);
+        }
+        REQUIRE(counter.get() == 1000);
+        REQUIRE(counter.spawn(hyp::StopToken()).get() == 1000);
+
+        auto chained = counter.then([m = 0](int x) mutable { return x + ++m; });
+        REQUIRE(chained.run().get() == 1001);
+        REQUIRE(chained.run().get() == 1001);
+
+        // A callable without state is shared by all runs instead of being copied
+        CountedBuffer::copies = 0;
+        const CountedBuffer buffer(10);
+        hyp::Task<size_t()> shared([buffer]() { return buffer.data.size(); });
+        const int copies = CountedBuffer::copies.load();
+        REQUIRE(shared.run().get() == 10);
+        REQUIRE(shared.get() == 10);
+        REQUIRE(CountedBuffer::copies == copies);
+    }
+
+    SECTION("Task then chain")
+    {
+        hyp::Task<double(int)> task1([](int x) -> double { return x * 2.0; });
+        auto task2 = task1.then([](double x) { return x + 3.0; });
+        REQUIRE(task2.get(5) == Catch::Approx(13.0));
+    }
+
+    SECTION("Task then runs on the completing thread")
+    {
+        hyp::ThreadPool pool(2);
+        hyp::Task<std::thread::id(int)> first([](int) { return std::this_thread::get_id(); }, pool);
+        auto chained = first;
+        for (int i = 0; i < 8; ++i)
+        {
+            // Every link passes the id on only if it runs on the same thread as the first
+            chained = chained.then([](std::thread::id id)
+                                   { return id == std::this_thread::get_id() ? id : std::thread::id(); });
+        }
+        const auto id = chained.run(0).get();
+        REQUIRE(id != std::thread::id());
+        REQUIRE(id != std::this_thread::get_id());
+    }
+
+    SECTION("Task then with Expected")
+    {
+        hyp::Task<double(int)> task1(
+            [](int x) -> double
+            {
+                if (x < 0)
+                {
+                    throw std::invalid_argument("negative");
+                }
+                return x * 2.0;
+            });
+        auto recovered = task1.then([](hyp::Expected<double> res) { return res ? *res : -1.0; });
+        REQUIRE(recovered.get(5) == Catch::Approx(10.0));
+        REQUIRE(recovered.get(-5) == Catch::Approx(-1.0));
+        REQUIRE_THROWS_AS(task1.then([](double x) { return x; }).get(-5), std::invalid_argument);
+    }
+
+    SECTION("Task with member function")
+    {
+        TestClass obj;
+        hyp::Task<double(int)> task([&obj](int x) -> double { return obj.member_task(x); });
+        REQUIRE(task.get(4) == Catch::Approx(8.0));
+    }
+}
+
+TEST_CASE("Worker functionality", "[Worker]")
+{
+    TestClass obj;
+    hyp::Worker<double, int> worker;
+
+    SECTION("Add different task types")
+    {
+        worker.add_function("func1", fast_task);
+        worker.add_function("func2", &TestClass::member_task, &obj);
+        worker.add_function("func3", &TestClass::static_task);
+        worker.add_function("func4", [](int x) { return x * 1.0; });
+        REQUIRE(worker.execute_all(4).size() == 4);
+    }
+
+    SECTION("Execute Any strategy")
+    {
+        worker.add_function("fast", fast_task);
+        worker.add_function("slow", slow_task);
+
+        auto start = std::chrono::steady_clock::now();
+        auto result = worker.execute_any(3);
+        auto duration = std::chrono::steady_clock::now() - start;
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
+
+        REQUIRE(result.has_value());
+        REQUIRE(result.value().second == Catch::Approx(9.0));
+        REQUIRE(ms < 50);
+    }
+
+    SECTION("Execute AnyWith strategy")
+    {
+        worker.add_function("func7", [](int x) { return x * 10; });
+        worker.add_function("func8", [](int x) { return x * 20; });
+        worker.add_function("func9", [](int x) { return x * 30; });
+
+        auto result = worker.execute_any_with([](double val) { return val > 250; }, 10);
+        REQUIRE(result.has_value());
+        REQUIRE(result.value().second == Catch::Approx(300.0));
+    }
+
+    SECTION("Execute All strategy")
+    {
+        worker.add_function("fast", fast_task);
+        worker.add_function("slow",
+                            [](int x)
+                            {
+                                std::this_thread::sleep_for(50ms);
+                                return x * 1.0;
+                            });
+        worker.add_function("conditional", conditional_task);
+
+        auto results = worker.execute_all(3, 100ms);
+        REQUIRE(results.size() == 3);
+    }
+
+    SECTION("Execute Best strategy")
+    {
+        worker.add_function("func13", [](int x) { return x * 1.0; });
+        worker.add_function("func14", [](int x) { return x * 2.0; });
+        worker.add_function("func15", [](int x) { return x * 3.0; });
+
+        auto result = worker.execute_best([](double a, double b) { return a < b; }, 5);
+        REQUIRE(result.has_value());
+        REQUIRE(result.value().second == Catch::Approx(5.0));
+    }
+
+    SECTION("Execute OrderWith strategy")
+    {
+        worker.add_function("func16", [](int x) { return x * 1.0; });
+        worker.add_function("func17", [](int x) { return x * 3.0; });
+        worker.add_function("func18", [](int x) { return x * 2.0; });
+
+        auto result = worker.execute_order_with([](double val) { return val > 12; }, 5);
+        REQUIRE(result.has_value());
+        REQUIRE(result.value().second == Catch::Approx(15.0));
+    }
+
+    SECTION("Execute OrderWith with timeout")
+    {
+        worker.add_function("func19",
+                            [](int)
+                            {
+                                std::this_thread::sleep_for(30ms);
+                                return 1.0;
+                            });
+        worker.add_function("func20",
+                            [](int)
+                            {
+                                std::this_thread::sleep_for(10ms);
+                                return 2.0;
+                            });
+
+        auto result = worker.execute_order_with([](double val) { return val > 0; }, 3, 40ms);
+        REQUIRE(result.has_value());
+    }
+
+    SECTION("AnyWith with no match")
+    {
+        worker.add_function("func21", [](int x) { return x * 1.0; });
+        worker.add_function("func22", [](int x) { return x * 2.0; });
+
+        auto result = worker.execute_any_with([](double val) { return val > 100; }, 10);
+        REQUIRE_FALSE(result.has_value());
+    }
+
+    SECTION("Empty worker handling")
+    {
+        REQUIRE_FALSE(worker.execute_any(5).has_value());
+        REQUIRE_FALSE(worker.execute_any_with([](double) { return true; }, 5).has_value());
+        REQUIRE(worker.execute_all(5).empty());
+        REQUIRE_FALSE(worker.execute_best([](double, double) { return true; }, 5).has_value());
+        REQUIRE_FALSE(worker.execute_order_with([](double) { return true; }, 5).has_value());
+    }
+}
+
+TEST_CASE("Composite tasks", "[composite]")
+{
+    SECTION("All composite task")
+    {
+        std::vector<hyp::Task<double(int)>> tasks;
+        tasks.emplace_back([](int x) { return x * 1.0; });
+        tasks.emplace_back([](int x) { return x * 2.0; });
+        tasks.emplace_back([](int x) { return x * 3.0; });
+
+        auto composite = hyp::All(tasks, 0ms, 5);
+        auto results_opt = composite.get();
+        REQUIRE(results_opt.has_value());
+        auto results = *results_opt;
+        REQUIRE(results.size() == 3);
+        REQUIRE(results[0] == Catch::Approx(5.0));
+        REQUIRE(results[1] == Catch::Approx(10.0));
+        REQUIRE(results[2] == Catch::Approx(15.0));
+    }
+
+    SECTION("Any composite task")
+    {
+        std::vector<hyp::Task<double(int)>> tasks;
+        tasks.emplace_back(
+            [](int)
+            {
+                std::this_thread::sleep_for(50ms);
+                return 1.0;
+            });
+        tasks.emplace_back([](int) { return 2.0; });
+
+        auto composite = hyp::Any(tasks, 0ms, 0);
+        auto [index, result_opt] = composite.get();
+        REQUIRE(index == 1);
+        REQUIRE(result_opt.value() == Catch::Approx(2.0));
+    }
+
+    SECTION("Best composite task")
+    {
+        std::vector<hyp::Task<double(int)>> tasks;
+        tasks.emplace_back([](int x) { return x * 3.0; });
+        tasks.emplace_back([](int x) { return x * 1.0; });
+        tasks.emplace_back([](int x) { return x * 2.0; });
+
+        auto composite = hyp::Best([](double a, double b) { return a < b; }, tasks, 0ms, 5);
+        auto result_opt = composite.get();
+        REQUIRE(result_opt.has_value());
+        REQUIRE(*result_opt == Catch::Approx(5.0));
+    }
+}
+
+TEST_CASE("Timeout handling", "[timeout]")
+{
+    hyp::Worker<double, int> worker;
+
+    SECTION("Any with timeout")
+    {
+        worker.add_function("func1",
+                            [](int)
+                            {
+                                std::this_thread::sleep_for(100ms);
+                                return 1.0;
+                            });
+        worker.add_function("func2", [](int) { return 2.0; });
+
+        auto result = worker.execute_any(0, 50ms);
+        REQUIRE(result.has_value());
+        REQUIRE(result.value().second == Catch::Approx(2.0));
+    }
+
+    SECTION("AnyWith with timeout")
+    {
+        worker.add_function("func3",
+                            [](int)
+                            {
+                                std::this_thread::sleep_for(20ms);
+                                return 10.0;
+                            });
+        worker.add_function("func4",
+                            [](int)
+                            {
+                                std::this_thread::sleep_for(60ms);
+                                return 20.0;
+                            });
+
+        auto result = worker.execute_any_with([](double val) { return val > 15; }, 3, 40ms);
+        REQUIRE_FALSE(result.has_value());
+    }
+
+    SECTION("All with partial results")
+    {
+        worker.add_function("func5",
+                            [](int x)
+                            {
+                                std::this_thread::sleep_for(10ms);
+                                return x * 1.0;
+                            });
+        worker.add_function("func6",
+                            [](int x)
+                            {
+                                std::this_thread::sleep_for(50ms);
+                                return x * 2.0;
+                            });
+        worker.add_function("func7",
+                            [](int x)
+                            {
+                                std::this_thread::sleep_for(100ms);
+                                return x * 3.0;
+                            });
+
+        auto results = worker.execute_all(5, 60ms);
+        REQUIRE(results.size() == 0); // All must be completed to be considered complete
+    }
+
+    SECTION("Partial All keeps what finished in time")
+    {
+        worker.add_function("fast", [](int x) { return x * 1.0; });
+        worker.add_function("throws", [](int) -> double { throw std::runtime_error("throws"); });
+        worker.add_function("late",
+                            [](int x)
+                            {
+                                std::this_thread::sleep_for(100ms);
+                                return x * 3.0;
+                            });
+
+        auto start = std::chrono::steady_clock::now();
+        auto results = worker.execute_all_partial(5, 30ms);
+        REQUIRE(std::chrono::steady_clock::now() - start < 90ms);
+        REQUIRE(results.size() == 3);
+        REQUIRE(results[0].first == "fast");
+        REQUIRE(results[0].second.status() == hyp::OutcomeStatus::Value);
+        REQUIRE(*results[0].second == Catch::Approx(5.0));
+        REQUIRE(results[1].second.status() == hyp::OutcomeStatus::Threw);
+        REQUIRE_THROWS_AS(results[1].second.value(), std::runtime_error);
+        REQUIRE(results[2].second.status() == hyp::OutcomeStatus::TimedOut);
+        REQUIRE_THROWS_AS(results[2].second.value(), hyp::TaskTimedOut);
+
+        auto complete = worker.execute_all_partial(5);
+        REQUIRE(complete[2].second.status() == hyp::OutcomeStatus::Value);
+        REQUIRE(*complete[2].second == Catch::Approx(15.0));
+    }
+
+    SECTION("Best with partial results")
+    {
+        worker.add_function("func8",
+                            [](int x)
+                            {
+                                std::this_thread::sleep_for(10ms);
+                                return x * 3.0;
+                            });
+        worker.add_function("func9",
+                            [](int x)
+                            {
+                                std::this_thread::sleep_for(50ms);
+                                return x * 1.0;
+                            });
+        worker.add_function("func10",
+                            [](int x)
+                            {
+                                std::this_thread::sleep_for(100ms);
+                                return x * 2.0;
+                            });
+
+        auto result = worker.execute_best([](double a, double b) { return a < b; }, 5, 60ms);
+        REQUIRE_FALSE(result.has_value()); // Best must be completed to be considered complete
+    }
+}
+
+TEST_CASE("Performance testing", "[performance]")
+{
+    constexpr int TASK_COUNT = 100;
+    hyp::Worker<double, int> worker;
+
+    for (int i = 0; i < TASK_COUNT; i++)
+    {
+        worker.add_function("task_" + std::to_string(i), [i](int x) { return x * i; });
+    }
+
+    SECTION("Any strategy performance")
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        auto result = worker.execute_any(5);
+        auto duration = std::chrono::high_resolution_clock::now() - start;
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
+
+        REQUIRE(result.has_value());
+        std::cout << "Any strategy with " << TASK_COUNT << " tasks took " << ms << " ms\n";
+        REQUIRE(ms < 50);
+    }
+
+    SECTION("All strategy performance")
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        auto results = worker.execute_all(5);
+        auto duration = std::chrono::high_resolution_clock::now() - start;
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
+
+        REQUIRE(results.size() == TASK_COUNT);
+        std::cout << "All strategy with " << TASK_COUNT << " tasks took " << ms << " ms\n";
+    }
+}
+
+TEST_CASE("Thread pool overhead", "[performance]")
+{
+    constexpr int TASK_COUNT = 1000;
+    hyp::Task<int(int)> task([](int x) { return x + 1; });
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<std::shared_future<int>> thread_futs;
+    for (int i = 0; i < TASK_COUNT; i++)
+    {
+        auto packaged = std::make_shared<std::packaged_task<int(int)>>([](int x) { return x + 1; });
+        thread_futs.push_back(packaged->get_future().share());
+        std::thread([packaged, i]() { (*packaged)(i); }).detach();
+    }
+    for (auto& fut : thread_futs)
+    {
+        fut.wait();
+    }
+    auto thread_us =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start)
+            .count();
+
+    start = std::chrono::high_resolution_clock::now();
+    std::vector<std::shared_future<int>> pool_futs;
+    for (int i = 0; i < TASK_COUNT; i++)
+    {
+        pool_futs.push_back(task.run(i));
+    }
+    for (auto& fut : pool_futs)
+    {
+        fut.wait();
+    }
+    auto pool_us =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start)
+            .count();
+
+    std::cout << TASK_COUNT << " tasks took " << thread_us << " us on fresh threads and " << pool_us
+              << " us on the pool\n";
+    REQUIRE(pool_us < thread_us);
+}
+
+TEST_CASE("Thread pool", "[pool]")
+{
+    hyp::ThreadPool pool(2);
+
+    SECTION("Task runs on bound pool")
+    {
+        hyp::Task<bool()> task([&pool]() { return hyp::ThreadPool::current() == &pool; }, pool);
+        REQUIRE(task.run().get());
+    }
+
+    SECTION("Worker runs on injected pool")
+    {
+        hyp::Worker<bool, int> worker(pool);
+        worker.add_function("on_pool_1", [&pool](int) { return hyp::ThreadPool::current() == &pool; });
+        worker.add_function("on_pool_2", [&pool](int) { return hyp::ThreadPool::current() == &pool; });
+
+        auto results = worker.execute_all(0);
+        REQUIRE(results.size() == 2);
+        REQUIRE(results[0].second);
+        REQUIRE(results[1].second);
+    }
+
+    SECTION("Nested waits do not exhaust the pool")
+    {
+        hyp::ThreadPool single(1);
+        std::vector<hyp::Task<double(int)>> tasks;
+        tasks.emplace_back([](int x) { return x * 1.0; }, single);
+        tasks.emplace_back([](int x) { return x * 2.0; }, single);
+
+        auto results_opt = hyp::All(tasks, 0ms, 5).run().get();
+        REQUIRE(results_opt.has_value());
+        REQUIRE(results_opt->size() == 2);
+
+        // With a deadline a spare thread runs them while the waiting thread blocks
+        REQUIRE(hyp::All(tasks, 10s, 5).run().get().has_value());
+        REQUIRE(hyp::AllPartial(tasks, 10s, 5).run().get()[1].status() == hyp::OutcomeStatus::Value);
+        REQUIRE(hyp::OrderWith([](double x) { return x > 5; }, tasks, 10s, 5).run().get().first == 1);
+    }
+
+    SECTION("Nested waits keep their deadline")
+    {
+        for (size_t threads : {1, 4})
+        {
+            hyp::ThreadPool shared(threads);
+            hyp::Worker<int, int> worker(shared);
+            for (int i = 0; i < 3; ++i)
+            {
+                worker.add_function("slow" + std::to_string(i),
+                                    [](int x)
+                                    {
+                                        std::this_thread::sleep_for(200ms);
+                                        return x;
+                                    });
+            }
+
+            // The waiting thread must not pick up one of the slow functions and overrun its deadline
+            hyp::Task<long long()> nested(
+                [&worker]() -> long long
+                {
+                    const auto start = std::chrono::steady_clock::now();
+                    if (worker.execute_any(1, 5ms).has_value())
+                    {
+                        return -1;
+                    }
+                    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+                                                                                 start)
+                        .count();
+                },
+                shared);
+            const auto elapsed = nested.run().get();
+            REQUIRE(elapsed >= 0);
+            REQUIRE(elapsed < 100);
+        }
+    }
+
+    SECTION("Completion waits help the pool")
+    {
+        hyp::ThreadPool single(1);
+        std::vector<hyp::Task<double(int)>> tasks;
+        tasks.emplace_back([](int x) { return x * 1.0; }, single);
+        tasks.emplace_back([](int x) { return x * 2.0; }, single);
+        const auto less = [](double a, double b) { return a < b; };
+
+        // Each combinator runs on the single thread and must run its own tasks while waiting
+        REQUIRE(hyp::Any(tasks, 0ms, 1).run().get().first >= 0);
+        REQUIRE(hyp::Any(tasks, 10s, 1).run().get().first >= 0);
+        REQUIRE(hyp::Best(less, tasks, 10s, 1).run().get().value() == Catch::Approx(1.0));
+        REQUIRE(hyp::Hedged(tasks, 1ms, 10s, 1).run().get().first >= 0);
+        REQUIRE(hyp::Quorum(2, tasks, 10s, 1).run().get().size() == 2);
+        REQUIRE(hyp::Reduce(0.0, std::plus<double>(), tasks, 10s, 1).run().get() == Catch::Approx(3.0));
+        REQUIRE(hyp::TopK(1, less, tasks, 10s, 1).run().get().size() == 1);
+    }
+
+    SECTION("Nested workers do not exhaust the pool")
+    {
+        // More outer functions than threads, each blocking on an inner execution on the same pool
+        for (hyp::ThreadPool* shared : {&pool, &hyp::ThreadPool::global()})
+        {
+            hyp::Worker<int, int> inner(*shared);
+            inner.add_function("a", [](int x) { return x + 1; });
+            inner.add_function("b", [](int x) { return x + 2; });
+
+            hyp::Worker<int, int> outer(*shared);
+            for (int i = 0; i < 20; ++i)
+            {
+                outer.add_function("outer" + std::to_string(i),
+                                   [&inner](int x) { return inner.execute_any(x).value_or(std::make_pair("", -1)).second; });
+            }
+
+            auto results = outer.execute_all(1);
+            REQUIRE(results.size() == 20);
+            REQUIRE(std::all_of(results.begin(), results.end(), [](const auto& r) { return r.second > 1; }));
+            REQUIRE(outer.execute_any(1)->second > 1);
+        }
+    }
+
+    SECTION("Nested submissions are stolen by idle workers")
+    {
+        hyp::ThreadPool stealing(4);
+        std::mutex mutex;
+        std::set<std::thread::id> threads;
+        hyp::Task<int()> leaf(
+            [&]()
+            {
+                std::this_thread::sleep_for(1ms);
+                std::lock_guard<std::mutex> lock(mutex);
+                threads.insert(std::this_thread::get_id());
+                return 1;
+            },
+            stealing);
+        hyp::Task<int()> root(
+            [&]()
+            {
+                std::vector<std::shared_future<int>> futs;
+                for (int i = 0; i < 64; i++)
+                {
+                    futs.push_back(leaf.run());
+                }
+                int sum = 0;
+                for (auto& fut : futs)
+                {
+                    sum += fut.get();
+                }
+                return sum;
+            },
+            stealing);
+
+        REQUIRE(root.run().get() == 64);
+        REQUIRE(threads.size() > 1);
+    }
+
+    SECTION("Per-execution state is recycled")
+    {
+        void* first = hyp::aux::BlockPool::allocate(100);
+        REQUIRE(reinterpret_cast<std::uintptr_t>(first) % hyp::aux::BlockPool::block_align == 0);
+        hyp::aux::BlockPool::deallocate(first, 100);
+        void* second = hyp::aux::BlockPool::allocate(128);
+        REQUIRE(second == first);
+        hyp::aux::BlockPool::deallocate(second, 128);
+
+        // Blocks allocated here and freed on pool threads come back in batches
+        hyp::Worker<double, int> worker(pool);
+        worker.add_function("a", fast_task);
+        worker.add_function("b", fast_task);
+        int found = 0;
+        for (int i = 0; i < 1000; ++i)
+        {
+            found += worker.execute_any(i).has_value() ? 1 : 0;
+        }
+        REQUIRE(found == 1000);
+    }
+}
+
+TEST_CASE("Boundary testing", "[boundary]")
+{
+    hyp::Worker<double, int> worker;
+
+    SECTION("Large number of tasks")
+    {
+        constexpr int TASK_COUNT = 1000;
+        for (int i = 0; i < TASK_COUNT; i++)
+        {
+            worker.add_function("task_" + std::to_string(i), [i](int x) { return x * i; });
+        }
+
+        auto results = worker.execute_all(5);
+        REQUIRE(results.size() == TASK_COUNT);
+    }
+
+    SECTION("Long running tasks of any")
+    {
+        worker.add_function("long_task1",
+                            [](int)
+                            {
+                                std::this_thread::sleep_for(2s);
+                                return 1.0;
+                            });
+        worker.add_function("long_task2",
+                            [](int)
+                            {
+                                std::this_thread::sleep_for(2s);
+                                return 2.0;
+                            });
+
+        auto start = std::chrono::steady_clock::now();
+        auto result = worker.execute_any(0, 100ms);
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+        REQUIRE_FALSE(result.has_value());
+        REQUIRE(duration < 300ms);
+    }
+
+    SECTION("Long running tasks of all")
+    {
+        worker.add_function("long_task3",
+                            [](int)
+                            {
+                                std::this_thread::sleep_for(2s);
+                                return 1.0;
+                            });
+        worker.add_function("long_task4",
+                            [](int)
+                            {
+                                std::this_thread::sleep_for(2s);
+                                return 2.0;
+                            });
+
+        auto start = std::chrono::steady_clock::now();
+        auto result = worker.execute_all(0, 100ms);
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+        REQUIRE(result.empty());
+        REQUIRE(duration < 150ms);
+    }
+}
+
+TEST_CASE("Task exception handling", "[task]")
+{
+    SECTION("Task with exception in run")
+    {
+        hyp::Task<double(int)> task(
+            [](int x) -> double
+            {
+                if (x == 0)
+                {
+                    throw std::runtime_error("error");
+                }
+                return x * 1.0;
+            });
+
+        auto fut = task.run(0);
+        REQUIRE_THROWS_AS(fut.get(), std::runtime_error);
+    }
+
+    SECTION("Task with exception in then chain")
+    {
+        hyp::Task<double(int)> task1([](int x) -> double { return x * 2.0; });
+        auto task2 = task1.then(
+            [](double x)
+            {
+                if (x > 10)
+                {
+                    throw std::overflow_error("overflow");
+                }
+                return x;
+            });
+
+        REQUIRE_NOTHROW(task2.get(5));
+        REQUIRE_THROWS_AS(task2.get(10), std::overflow_error);
+    }
+}
+
+TEST_CASE("Worker exception handling", "[Worker]")
+{
+    hyp::Worker<double, int> worker;
+
+    SECTION("All with exception")
+    {
+        worker.add_function("good", [](int x) { return x * 1.0; });
+        worker.add_function("bad", [](int) -> double { throw std::logic_error("bad task"); });
+
+        auto results = worker.execute_all(5);
+        REQUIRE(results.size() == 0);
+    }
+
+    SECTION("Any with exception")
+    {
+        worker.add_function("fast", [](int) -> double { throw std::runtime_error("fast error"); });
+        worker.add_function("slow",
+                            [](int x)
+                            {
+                                std::this_thread::sleep_for(50ms);
+                                return x * 1.0;
+                            });
+
+        auto result = worker.execute_any(5, 100ms);
+        REQUIRE(result.has_value());
+        REQUIRE(result.value().second == Catch::Approx(5.0));
+    }
+}
+
+TEST_CASE("Any completion latency", "[composite]")
+{
+    constexpr int TASK_COUNT = 60;
+    hyp::ThreadPool pool(TASK_COUNT);
+    std::vector<hyp::Task<double(int)>> tasks;
+    for (int i = 0; i < TASK_COUNT; i++)
+    {
+        auto delay = i == TASK_COUNT / 2 ? 10ms : 200ms;
+        tasks.emplace_back(
+            [delay, i](int)
+            {
+                std::this_thread::sleep_for(delay);
+                return i * 1.0;
+            },
+            pool);
+    }
+
+    SECTION("Any wakes up on the first completion")
+    {
+        auto start = std::chrono::steady_clock::now();
+        auto [index, result_opt] = hyp::Any(tasks, 0ms, 0).get();
+        auto duration = std::chrono::steady_clock::now() - start;
+
+        REQUIRE(index == TASK_COUNT / 2);
+        REQUIRE(result_opt.has_value());
+        REQUIRE(duration < 50ms);
+    }
+
+    SECTION("AnyWith wakes up on the first accepted completion")
+    {
+        auto start = std::chrono::steady_clock::now();
+        auto [index, result_opt] = hyp::AnyWith([](double v) { return v > 0; }, tasks, 100ms, 0).get();
+        auto duration = std::chrono::steady_clock::now() - start;
+
+        REQUIRE(index == TASK_COUNT / 2);
+        REQUIRE(result_opt.has_value());
+        REQUIRE(duration < 50ms);
+    }
+}
+
+TEST_CASE("Shared arguments", "[composite]")
+{
+    SECTION("Large arguments are shared by the tasks")
+    {
+        std::vector<hyp::Task<double(const CountedBuffer&)>> tasks;
+        for (int i = 1; i <= 20; ++i)
+        {
+            tasks.emplace_back([i](const CountedBuffer& buffer)
+                               { return i * std::accumulate(buffer.data.begin(), buffer.data.end(), 0.0); });
+        }
+
+        CountedBuffer::copies = 0;
+        auto all = hyp::All(tasks, 0ms, CountedBuffer(1000)).get();
+        REQUIRE(all.has_value());
+        REQUIRE(all->size() == 20);
+        REQUIRE((*all)[19] == Catch::Approx(20000.0));
+
+        auto best = hyp::Best([](double a, double b) { return a > b; }, tasks, 0ms, CountedBuffer(10)).get();
+        REQUIRE(best.value() == Catch::Approx(200.0));
+        REQUIRE(hyp::Any(tasks, 0ms, CountedBuffer(10)).get().first >= 0);
+        REQUIRE(CountedBuffer::copies == 0);
+    }
+
+    SECTION("Move-only arguments")
+    {
+        using Buffer = std::unique_ptr<std::vector<float>>;
+        std::vector<hyp::Task<size_t(const Buffer&)>> tasks;
+        tasks.emplace_back([](const Buffer& buffer) { return buffer->size(); });
+        tasks.emplace_back([](const Buffer& buffer) { return buffer->size() * 2; });
+
+        auto all = hyp::All(tasks, 0ms, std::make_unique<std::vector<float>>(10)).get();
+        REQUIRE(all.has_value());
+        REQUIRE((*all)[1] == 20);
+        REQUIRE(hyp::Any(tasks, 0ms, std::make_unique<std::vector<float>>(10)).get().second.value() % 10 == 0);
+    }
+
+    SECTION("Worker copies arguments once per execution")
+    {
+        hyp::Worker<double, const CountedBuffer&> worker;
+        for (int i = 0; i < 10; ++i)
+        {
+            worker.add_function("fn" + std::to_string(i),
+                                [](const CountedBuffer& buffer) { return static_cast<double>(buffer.data.size()); });
+        }
+
+        const CountedBuffer buffer(100);
+        CountedBuffer::copies = 0;
+        REQUIRE(worker.execute_all(buffer).size() == 10);
+        REQUIRE(CountedBuffer::copies == 1);
+    }
+
+    SECTION("Worker moves move-only arguments")
+    {
+        hyp::Worker<int, std::unique_ptr<int>> worker;
+        worker.add_function("value", [](const std::unique_ptr<int>& value) { return *value; });
+        worker.add_function("double", [](const std::unique_ptr<int>& value) { return *value * 2; });
+
+        REQUIRE(worker.execute_all(std::make_unique<int>(5)).size() == 2);
+        REQUIRE(worker.execute_any(std::make_unique<int>(5)).value().second % 5 == 0);
+        REQUIRE(worker.execute_best([](int a, int b) { return a > b; }, std::make_unique<int>(5)).value().second == 10);
+        REQUIRE(worker.execute_top_k(1, [](int a, int b) { return a > b; }, std::make_unique<int>(5))[0].second == 10);
+    }
+
+    SECTION("Worker borrows move-only arguments taken by reference")
+    {
+        std::atomic<int> running{0};
+        hyp::Worker<int, const std::unique_ptr<int>&> worker;
+        worker.add_function("value", [](const std::unique_ptr<int>& value) { return *value; });
+        worker.add_function("slow",
+                            [&running](const std::unique_ptr<int>& value)
+                            {
+                                ++running;
+                                std::this_thread::sleep_for(20ms);
+                                const int result = *value * 2;
+                                --running;
+                                return result;
+                            });
+
+        const auto value = std::make_unique<int>(7);
+        REQUIRE(worker.execute_all(value).size() == 2);
+        // The losing function still reads the argument, so the call returns only once it is done with it
+        REQUIRE(worker.execute_any(value).value().second % 7 == 0);
+        REQUIRE(running == 0);
+        REQUIRE(worker.execute_any(value, 1ms).value_or(std::make_pair(std::string(), 0)).second % 7 == 0);
+        REQUIRE(running == 0);
+        REQUIRE(worker.execute_any_with([](int x) { return x == 7; }, value).value().second == 7);
+        REQUIRE(running == 0);
+    }
+}
+
+TEST_CASE("Cooperative cancellation", "[cancel]")
+{
+    SECTION("Losing tasks observe the stop token")
+    {
+        std::atomic<bool> stopped{false};
+        std::vector<hyp::Task<double(int)>> tasks;
+        tasks.emplace_back(
+            [&stopped](const hyp::StopToken& token, int x)
+            {
+                auto deadline = std::chrono::steady_clock::now() + 2s;
+                while (!token.stop_requested() && std::chrono::steady_clock::now() < deadline)
+                {
+                    std::this_thread::sleep_for(1ms);
+                }
+                stopped = token.stop_requested();
+                return x * 1.0;
+            });
+        tasks.emplace_back([](int x) { return x * 2.0; });
+
+        auto [index, result_opt] = hyp::Any(tasks, 0ms, 5).get();
+        REQUIRE(index == 1);
+        REQUIRE(result_opt.value() == Catch::Approx(10.0));
+
+        auto start = std::chrono::steady_clock::now();
+        while (!stopped && std::chrono::steady_clock::now() - start < 1s)
+        {
+            std::this_thread::sleep_for(1ms);
+        }
+        REQUIRE(stopped);
+    }
+
+    SECTION("Tasks queued behind the winner are skipped")
+    {
+        hyp::ThreadPool pool(1);
+        std::atomic<int> started{0};
+        std::vector<hyp::Task<double(int)>> tasks;
+        tasks.emplace_back([](int x) { return x * 1.0; }, pool);
+        for (int i = 0; i < 10; i++)
+        {
+            tasks.emplace_back(
+                [&started](int x)
+                {
+                    ++started;
+                    return x * 2.0;
+                },
+                pool);
+        }
+
+        auto [index, result_opt] = hyp::AnyWith([](double) { return true; }, tasks, 0ms, 5).get();
+        REQUIRE(index == 0);
+
+        hyp::Task<int()> drain([]() { return 0; }, pool);
+        drain.run().wait();
+        REQUIRE(started + pool.cancelled() == 10);
+        REQUIRE(pool.cancelled() > 0);
+    }
+
+    SECTION("OrderWith stops the remaining tasks")
+    {
+        hyp::ThreadPool pool(1);
+        std::vector<hyp::Task<double(int)>> tasks;
+        for (int i = 0; i < 5; i++)
+        {
+            tasks.emplace_back(
+                [](int x)
+                {
+                    std::this_thread::sleep_for(5ms);
+                    return x * 1.0;
+                },
+                pool);
+        }
+
+        auto [index, result_opt] = hyp::OrderWith([](double) { return true; }, tasks, 0ms, 5).get();
+        REQUIRE(index == 0);
+
+        hyp::Task<int()> drain([]() { return 0; }, pool);
+        drain.run().wait();
+        REQUIRE(pool.cancelled() > 0);
+    }
+
+    SECTION("Stop source and token")
+    {
+        hyp::StopToken never;
+        REQUIRE_FALSE(never.stop_possible());
+        REQUIRE_FALSE(never.stop_requested());
+
+        hyp::StopSource source;
+        auto token = source.get_token();
+        REQUIRE(token.stop_possible());
+        REQUIRE_FALSE(token.stop_requested());
+        REQUIRE(source.request_stop());
+        REQUIRE_FALSE(source.request_stop());
+        REQUIRE(token.stop_requested());
+    }
+}
+
+TEST_CASE("Best runs each function once", "[Worker]")
+{
+    SECTION("Single execution with winner index")
+    {
+        std::atomic<int> calls{0};
+        hyp::Worker<double, int> worker;
+        worker.add_function("triple",
+                            [&calls](int x)
+                            {
+                                ++calls;
+                                return x * 3.0;
+                            });
+        worker.add_function("single",
+                            [&calls](int x)
+                            {
+                                ++calls;
+                                return x * 1.0;
+                            });
+        worker.add_function("double",
+                            [&calls](int x)
+                            {
+                                ++calls;
+                                return x * 2.0;
+                            });
+
+        auto result = worker.execute_best([](double a, double b) { return a < b; }, 5);
+        REQUIRE(result.has_value());
+        REQUIRE(result->first == "single");
+        REQUIRE(result->second == Catch::Approx(5.0));
+        REQUIRE(calls == 3);
+    }
+
+    SECTION("Move-only and non-comparable results")
+    {
+        hyp::Worker<std::unique_ptr<int>, int> worker;
+        worker.add_function("plus", [](int x) { return std::make_unique<int>(x + 1); });
+        worker.add_function("minus", [](int x) { return std::make_unique<int>(x - 1); });
+
+        auto result = worker.execute_best([](const auto& a, const auto& b) { return *a < *b; }, 5);
+        REQUIRE(result.has_value());
+        REQUIRE(result->first == "minus");
+        REQUIRE(*result->second == 4);
+    }
+
+    SECTION("BestIndexed composite task")
+    {
+        std::vector<hyp::Task<double(int)>> tasks;
+        tasks.emplace_back([](int x) { return x * 3.0; });
+        tasks.emplace_back([](int x) { return x * 1.0; });
+        tasks.emplace_back([](int x) { return x * 1.0; });
+
+        auto [index, result_opt] = hyp::BestIndexed([](double a, double b) { return a < b; }, tasks, 0ms, 5).get();
+        REQUIRE(index == 1);
+        REQUIRE(result_opt.value() == Catch::Approx(5.0));
+    }
+
+    SECTION("Failure ends the wait early")
+    {
+        std::vector<hyp::Task<double(int)>> tasks;
+        tasks.emplace_back([](int) -> double { throw std::runtime_error("error"); });
+        tasks.emplace_back(
+            [](int x)
+            {
+                std::this_thread::sleep_for(200ms);
+                return x * 1.0;
+            });
+
+        auto start = std::chrono::steady_clock::now();
+        auto [index, result_opt] = hyp::BestIndexed([](double a, double b) { return a < b; }, tasks, 0ms, 5).get();
+        auto duration = std::chrono::steady_clock::now() - start;
+
+        REQUIRE(index == -1);
+        REQUIRE_FALSE(result_opt.has_value());
+        REQUIRE(duration < 100ms);
+    }
+}
+
+TEST_CASE("Static worker", "[StaticWorker]")
+{
+    SECTION("Strategies")
+    {
+        auto worker = hyp::make_worker<double(int)>(hyp::named("fast", fast_task),
+                                                    hyp::named("slow", slow_task),
+                                                    hyp::named("conditional", conditional_task));
+        REQUIRE(worker.names()[1] == "slow");
+
+        auto any = worker.execute_any(4);
+        REQUIRE(any.has_value());
+        REQUIRE(any->first == "fast");
+        REQUIRE(any->second == Catch::Approx(16.0));
+
+        auto any_with = worker.execute_any_with([](double r) { return r > 20; }, 4);
+        REQUIRE(any_with.has_value());
+        REQUIRE(any_with->first == "slow");
+
+        auto all = worker.execute_all(2);
+        REQUIRE(all.has_value());
+        REQUIRE((*all)[0] == Catch::Approx(4.0));
+        REQUIRE((*all)[1] == Catch::Approx(8.0));
+        REQUIRE((*all)[2] == Catch::Approx(2.0));
+
+        auto best = worker.execute_best([](double a, double b) { return a < b; }, 3);
+        REQUIRE(best.has_value());
+        REQUIRE(best->first == "conditional");
+
+        auto ordered = worker.execute_order_with([](double r) { return r < 10; }, 3);
+        REQUIRE(ordered.has_value());
+        REQUIRE(ordered->first == "fast");
+        REQUIRE(ordered->second == Catch::Approx(9.0));
+
+        REQUIRE_FALSE(worker.execute_all(2, 50ms).has_value());
+    }
+
+    SECTION("Failures and move-only results")
+    {
+        auto worker = hyp::make_worker<std::unique_ptr<int>(int)>(
+            hyp::named("throws", [](int) -> std::unique_ptr<int> { throw std::runtime_error("error"); }),
+            hyp::named("plus", [](int x) { return std::make_unique<int>(x + 1); }));
+
+        auto any = worker.execute_any(1);
+        REQUIRE(any.has_value());
+        REQUIRE(any->first == "plus");
+        REQUIRE(*any->second == 2);
+        REQUIRE_FALSE(worker.execute_all(1).has_value());
+        REQUIRE_FALSE(worker.execute_best([](const auto& a, const auto& b) { return *a < *b; }, 1).has_value());
+    }
+
+    SECTION("Executions do not allocate")
+    {
+        hyp::ThreadPool pool(1);
+        auto worker = hyp::make_worker<int(int)>(pool,
+                                                 hyp::named("square", [](int x) { return x * x; }),
+                                                 hyp::named("negate", [](int x) { return -x; }));
+
+        std::promise<void> ready;
+        pool.submit(
+            [&ready]()
+            {
+                t_countAllocations = true;
+                ready.set_value();
+            });
+        ready.get_future().wait();
+
+        // A loser may still be queued when a call returns, so two executions can overlap on one thread
+        worker.reserve(2);
+
+        g_allocations = 0;
+        t_countAllocations = true;
+        int total = 0;
+        for (int i = 0; i < 100; ++i)
+        {
+            total += worker.execute_any(i)->second;
+            total += (*worker.execute_all(i))[0];
+            total += worker.execute_best([](int a, int b) { return a < b; }, i)->second;
+            total += worker.execute_order_with([](int r) { return r >= 0; }, i)->second;
+        }
+        t_countAllocations = false;
+
+        REQUIRE(total != 0);
+        REQUIRE(g_allocations == 0);
+    }
+}
+
+TEST_CASE("Worker shares its functions between executions", "[Worker]")
+{
+    struct CountingFunction
+    {
+        explicit CountingFunction(std::atomic<int>& copies) : copies(&copies)
+        {
+        }
+
+        CountingFunction(const CountingFunction& other) : copies(other.copies), payload(other.payload)
+        {
+            ++*copies;
+        }
+
+        CountingFunction(CountingFunction&&) = default;
+
+        double operator()(int x) const
+        {
+            return x + payload[0];
+        }
+
+        std::atomic<int>* copies;
+        std::array<double, 16> payload{}; // Too large for small-buffer storage
+    };
+
+    std::atomic<int> copies{0};
+    hyp::Worker<double, int> worker;
+    for (int i = 0; i < 8; ++i)
+    {
+        worker.add_function("fn" + std::to_string(i), CountingFunction(copies));
+    }
+    const int registered = copies.load();
+
+    for (int i = 0; i < 20; ++i)
+    {
+        REQUIRE(worker.execute_any(i).has_value());
+        REQUIRE(worker.execute_any_with([](double r) { return r >= 0; }, i).has_value());
+        REQUIRE(worker.execute_all(i).size() == 8);
+        REQUIRE(worker.execute_best([](double a, double b) { return a < b; }, i).has_value());
+        REQUIRE(worker.execute_order_with([](double r) { return r >= 0; }, i).has_value());
+    }
+    REQUIRE(copies == registered);
+
+    // Adding a function rebuilds the snapshot without copying the existing callables
+    worker.add_function("extra", CountingFunction(copies));
+    REQUIRE(copies == registered);
+    REQUIRE(worker.execute_all(1).size() == 9);
+}
+
+TEST_CASE("Worker updates while executing", "[Worker]")
+{
+    SECTION("Remove and replace")
+    {
+        hyp::Worker<double, int> worker;
+        worker.add_function("fast", fast_task);
+        worker.add_function("conditional", conditional_task);
+
+        REQUIRE(worker.replace_function("fast", [](int x) { return x * 10.0; }));
+        REQUIRE_FALSE(worker.replace_function("missing", fast_task));
+
+        auto results = worker.execute_all(2);
+        REQUIRE(results.size() == 2);
+        REQUIRE(results[0].first == "fast");
+        REQUIRE(results[0].second == Catch::Approx(20.0));
+
+        REQUIRE(worker.remove_function("fast"));
+        REQUIRE_FALSE(worker.remove_function("fast"));
+        results = worker.execute_all(2);
+        REQUIRE(results.size() == 1);
+        REQUIRE(results[0].first == "conditional");
+
+        TestClass obj;
+        REQUIRE(worker.replace_function("conditional", &TestClass::member_task, &obj));
+        REQUIRE(worker.execute_any(4)->second == Catch::Approx(8.0));
+    }
+
+    SECTION("Concurrent readers and writers")
+    {
+        hyp::Worker<int, int> worker;
+        worker.add_function("identity", [](int x) { return x; });
+
+        std::atomic<bool> done{false};
+        std::atomic<int> failures{0};
+        std::vector<std::thread> readers;
+        for (int r = 0; r < 4; ++r)
+        {
+            readers.emplace_back(
+                [&worker, &done, &failures]()
+                {
+                    while (!done)
+                    {
+                        auto result = worker.execute_any(7);
+                        if (!result || result->second != 7)
+                        {
+                            ++failures;
+                        }
+                    }
+                });
+        }
+
+        for (int i = 0; i < 200; ++i)
+        {
+            const auto name = "fn" + std::to_string(i % 8);
+            if (i % 3 == 2)
+            {
+                worker.remove_function(name);
+            }
+            else if (!worker.replace_function(name, [](int x) { return x; }))
+            {
+                worker.add_function(name, [](int x) { return x; });
+            }
+        }
+        done = true;
+        for (auto& reader : readers)
+        {
+            reader.join();
+        }
+
+        REQUIRE(failures == 0);
+    }
+
+    SECTION("Snapshot stress")
+    {
+        hyp::Worker<int, int> worker;
+        worker.add_function("identity", [](int x) { return x; });
+
+        // Many readers and several writers, so readers get preempted between epochs
+        std::atomic<bool> done{false};
+        std::atomic<int> failures{0};
+        std::vector<std::thread> threads;
+        for (int r = 0; r < 8; ++r)
+        {
+            threads.emplace_back(
+                [&worker, &done, &failures, r]()
+                {
+                    while (!done)
+                    {
+                        if (r % 2 == 0)
+                        {
+                            worker.stats();
+                            continue;
+                        }
+                        for (const auto& result : worker.execute_all(3))
+                        {
+                            failures += result.second == 3 ? 0 : 1;
+                        }
+                    }
+                });
+        }
+
+        std::vector<std::thread> writers;
+        for (int w = 0; w < 4; ++w)
+        {
+            writers.emplace_back(
+                [&worker, w]()
+                {
+                    for (int i = 0; i < 2000; ++i)
+                    {
+                        const auto name = "w" + std::to_string(w) + "_" + std::to_string(i % 4);
+                        if (!worker.remove_function(name))
+                        {
+                            worker.add_function(name, [](int x) { return x; });
+                        }
+                    }
+                });
+        }
+        for (auto& writer : writers)
+        {
+            writer.join();
+        }
+        done = true;
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        REQUIRE(failures == 0);
+        REQUIRE(worker.execute_any(5)->second == 5);
+    }
+}
+
+TEST_CASE("Worker streaming", "[Worker]")
+{
+    hyp::Worker<double, int> worker;
+    worker.add_function("slow",
+                        [](int x)
+                        {
+                            std::this_thread::sleep_for(150ms);
+                            return x * 3.0;
+                        });
+    worker.add_function("medium",
+                        [](int x)
+                        {
+                            std::this_thread::sleep_for(30ms);
+                            return x * 2.0;
+                        });
+    worker.add_function("throws", [](int) -> double { throw std::runtime_error("throws"); });
+    worker.add_function("fast", [](int x) { return x * 1.0; });
+
+    SECTION("Completion order")
+    {
+        auto start = std::chrono::steady_clock::now();
+        auto stream = worker.execute_stream(2);
+        auto first = stream.next();
+        REQUIRE(std::chrono::steady_clock::now() - start < 100ms);
+        REQUIRE(first->first == "fast");
+        REQUIRE(first->second == Catch::Approx(2.0));
+        REQUIRE(stream.next()->first == "medium");
+        auto last = stream.next();
+        REQUIRE(last->first == "slow");
+        REQUIRE(last->second == Catch::Approx(6.0));
+        REQUIRE_FALSE(stream.next().has_value());
+    }
+
+    SECTION("Deadline ends the stream")
+    {
+        auto start = std::chrono::steady_clock::now();
+        auto stream = worker.execute_stream(2, 80ms);
+        size_t count = 0;
+        while (auto item = stream.next())
+        {
+            REQUIRE(item->first != "slow");
+            ++count;
+        }
+        REQUIRE(count == 2);
+        REQUIRE(std::chrono::steady_clock::now() - start < 140ms);
+    }
+
+    SECTION("Empty worker")
+    {
+        hyp::Worker<double, int> empty;
+        REQUIRE_FALSE(empty.execute_stream(1).next().has_value());
+    }
+}
+
+TEST_CASE("Inline functions", "[Worker]")
+{
+    const auto here = std::this_thread::get_id();
+    auto thread = []() { return std::this_thread::get_id(); };
+
+    SECTION("Task")
+    {
+        hyp::Task<std::thread::id()> task(thread);
+        REQUIRE_FALSE(task.is_inline());
+        REQUIRE(task.inlined().is_inline());
+        REQUIRE(task.inlined().run().get() == here);
+        REQUIRE(task.run().get() != here);
+    }
+
+    SECTION("Worker hint")
+    {
+        hyp::Worker<std::thread::id> worker;
+        worker.add_function("cheap", thread);
+        worker.add_function("pooled", thread);
+        REQUIRE(worker.set_inline("cheap"));
+        REQUIRE_FALSE(worker.set_inline("missing"));
+
+        auto all = worker.execute_all();
+        REQUIRE(all.size() == 2);
+        REQUIRE(all[0].second == here);
+        REQUIRE(all[1].second != here);
+
+        REQUIRE(worker.execute_order_with([&here](const std::thread::id& id) { return id == here; })->first == "cheap");
+
+        // Replacing keeps the hint
+        worker.replace_function("cheap", thread);
+        REQUIRE(worker.execute_all()[0].second == here);
+    }
+
+    SECTION("Classified from recorded latency")
+    {
+        hyp::Worker<double, int> worker;
+        worker.add_function("cheap", fast_task);
+        worker.add_function("costly",
+                            [](int x)
+                            {
+                                std::this_thread::sleep_for(2ms);
+                                return x * 1.0;
+                            });
+        worker.add_function("unused", fast_task);
+        REQUIRE(worker.classify_inline(100us) == 0);
+
+        worker.enable_stats();
+        for (int i = 0; i < 10; ++i)
+        {
+            worker.execute_all(i);
+        }
+        REQUIRE(worker.classify_inline(100us) == 2);
+        auto results = worker.execute_all(3);
+        REQUIRE(results.size() == 3);
+        REQUIRE(results[0].second == Catch::Approx(9.0));
+        REQUIRE(results[1].second == Catch::Approx(3.0));
+    }
+}
+
+TEST_CASE("Worker batch execution", "[Worker]")
+{
+    hyp::Worker<double, int> worker;
+    worker.add_function("square", fast_task);
+    worker.add_function("identity", [](int x) { return static_cast<double>(x); });
+    worker.add_function("odd_only",
+                        [](int x)
+                        {
+                            if (x % 2 == 0)
+                            {
+                                throw std::runtime_error("even");
+                            }
+                            return x * 10.0;
+                        });
+
+    std::vector<std::tuple<int>> inputs;
+    for (int i = 0; i < 1000; ++i)
+    {
+        inputs.emplace_back(i);
+    }
+
+    SECTION("All")
+    {
+        auto results = worker.execute_all_batch(inputs);
+        REQUIRE(results.rows() == 1000);
+        REQUIRE(results.cols() == 3);
+        REQUIRE(results.names()[2] == "odd_only");
+        for (size_t i = 0; i < results.rows(); ++i)
+        {
+            REQUIRE(results(i, 0) == Catch::Approx(static_cast<double>(i * i)));
+            REQUIRE(results(i, 1) == Catch::Approx(static_cast<double>(i)));
+            REQUIRE(results(i, 2).has_value() == (i % 2 == 1));
+            REQUIRE(results.complete(i) == (i % 2 == 1));
+        }
+    }
+
+    SECTION("Any")
+    {
+        auto results = worker.execute_any_batch(inputs);
+        REQUIRE(results.size() == 1000);
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            REQUIRE(results[i].has_value());
+            if (results[i]->first == "identity")
+            {
+                REQUIRE(results[i]->second == Catch::Approx(static_cast<double>(i)));
+            }
+        }
+    }
+
+    SECTION("Best")
+    {
+        auto results = worker.execute_best_batch([](double a, double b) { return a > b; }, inputs);
+        REQUIRE(results.size() == 1000);
+        REQUIRE_FALSE(results[2].has_value());
+        REQUIRE(results[3]->first == "odd_only");
+        REQUIRE(results[3]->second == Catch::Approx(30.0));
+        REQUIRE(results[21]->first == "square");
+    }
+
+    SECTION("Timeout and empty input")
+    {
+        hyp::Worker<double, int> slow;
+        slow.add_function("slow", slow_task);
+        auto start = std::chrono::steady_clock::now();
+        auto results = slow.execute_all_batch({{1}, {2}}, 50ms);
+        REQUIRE(std::chrono::steady_clock::now() - start < 150ms);
+        REQUIRE_FALSE(results(0, 0).has_value());
+
+        REQUIRE(worker.execute_any_batch({}).empty());
+        REQUIRE(hyp::Worker<double, int>().execute_all_batch(inputs).cols() == 0);
+    }
+}
+
+TEST_CASE("Worker statistics", "[Worker]")
+{
+    hyp::Worker<double, int> worker;
+    worker.add_function("square", fast_task);
+    worker.add_function("fails",
+                        [](int) -> double
+                        {
+                            throw std::runtime_error("fails");
+                        });
+    worker.add_function("late",
+                        [](int x)
+                        {
+                            std::this_thread::sleep_for(60ms);
+                            return static_cast<double>(x);
+                        });
+
+    SECTION("Disabled by default")
+    {
+        worker.execute_all(1);
+        for (const auto& stats : worker.stats())
+        {
+            REQUIRE(stats.completed + stats.failed + stats.timed_out + stats.wins == 0);
+            REQUIRE(stats.latency.count() == 0);
+        }
+    }
+
+    SECTION("Outcomes, wins and latency")
+    {
+        worker.enable_stats();
+        for (int i = 0; i < 5; ++i)
+        {
+            REQUIRE(worker.execute_any_with([](double) { return false; }, i, 20ms) == std::nullopt);
+        }
+        REQUIRE(worker.execute_any_with([](double x) { return x >= 0; }, 3)->first == "square");
+        std::this_thread::sleep_for(100ms);
+
+        auto stats = worker.stats();
+        REQUIRE(stats.size() == 3);
+        REQUIRE(stats[0].name == "square");
+        REQUIRE(stats[0].completed >= 5);
+        REQUIRE(stats[0].wins == 1);
+        REQUIRE(stats[1].failed >= 5);
+        REQUIRE(stats[1].completed == 0);
+        REQUIRE(stats[2].timed_out == 5);
+        REQUIRE(stats[2].latency.percentile(0.5) >= 60ms);
+        REQUIRE(stats[2].latency.percentile(0.5) >= stats[0].latency.percentile(0.99));
+        REQUIRE(stats[0].latency.count() == stats[0].completed);
+
+        // Replacing keeps the history, disabling freezes it
+        worker.replace_function("square", [](int x) { return static_cast<double>(x); });
+        worker.enable_stats(false);
+        worker.execute_all(1, 200ms);
+        REQUIRE(worker.stats()[0].completed == stats[0].completed);
+        REQUIRE(worker.stats()[0].wins == 1);
+    }
+
+    SECTION("Latency histogram buckets")
+    {
+        using Histogram = hyp::LatencyHistogram;
+        REQUIRE(Histogram::bucket_of(7ns) == 7);
+        for (auto ns : {16ns, 100ns, 12345ns, 1000000007ns})
+        {
+            const auto bucket = Histogram::bucket_of(ns);
+            REQUIRE(Histogram::lower_bound(bucket) <= ns);
+            REQUIRE(ns < Histogram::lower_bound(bucket + 1));
+            REQUIRE(ns - Histogram::lower_bound(bucket) <= ns / 16);
+        }
+        REQUIRE(Histogram::bucket_of(std::chrono::hours(1000)) == Histogram::bucket_count - 1);
+    }
+}
+
+TEST_CASE("Adaptive OrderWith", "[Worker]")
+{
+    hyp::Worker<double, int> worker;
+    worker.add_function("slow_fails",
+                        [](int)
+                        {
+                            std::this_thread::sleep_for(30ms);
+                            return -1.0;
+                        });
+    worker.add_function("slow_passes",
+                        [](int x)
+                        {
+                            std::this_thread::sleep_for(30ms);
+                            return static_cast<double>(x);
+                        });
+    worker.add_function("fast_passes", [](int x) { return x * 2.0; });
+    const auto positive = [](double x) { return x >= 0; };
+
+    REQUIRE(worker.order_mode() == hyp::OrderMode::Strict);
+    REQUIRE(worker.execute_order_with(positive, 3)->first == "slow_passes");
+
+    worker.set_order_mode(hyp::OrderMode::Adaptive);
+    // The first execution keeps registration order and learns latencies and pass rates
+    REQUIRE(worker.execute_order_with(positive, 3)->first == "slow_passes");
+    for (int i = 0; i < 5; ++i)
+    {
+        auto result = worker.execute_order_with(positive, i);
+        REQUIRE(result->first == "fast_passes");
+        REQUIRE(result->second == Catch::Approx(i * 2.0));
+    }
+
+    // Nothing passing still checks everything
+    REQUIRE_FALSE(worker.execute_order_with([](double) { return false; }, 1).has_value());
+
+    worker.set_order_mode(hyp::OrderMode::Strict);
+    REQUIRE(worker.execute_order_with(positive, 3)->first == "slow_passes");
+}
+
+TEST_CASE("Composite AnyWith", "[composite]")
+{
+    SECTION("AnyWith composite task")
+    {
+        std::vector<hyp::Task<double(int)>> tasks;
+        tasks.emplace_back(
+            [](int x)
+            {
+                std::this_thread::sleep_for(50ms);
+                return x * 1.0;
+            });
+        tasks.emplace_back(
+            [](int x)
+            {
+                std::this_thread::sleep_for(10ms);
+                return x * 3.0;
+            });
+        tasks.emplace_back(
+            [](int x)
+            {
+                std::this_thread::sleep_for(30ms);
+                return x * 4.0;
+            });
+
+        auto composite = hyp::AnyWith([](double val) { return val > 25; }, tasks, 100ms, 10);
+        auto [index, result_opt] = composite.get();
+
+        REQUIRE(index == 1);
+        REQUIRE(result_opt.value() == Catch::Approx(30.0));
+    }
+
+    SECTION("AnyWith no match")
+    {
+        std::vector<hyp::Task<double(int)>> tasks;
+        tasks.emplace_back([](int x) { return x * 1.0; });
+        tasks.emplace_back([](int x) { return x * 2.0; });
+
+        auto composite = hyp::AnyWith([](double val) { return val > 100; }, tasks, 100ms, 10);
+        auto [index, result_opt] = composite.get();
+
+        REQUIRE(index == -1);
+        REQUIRE_FALSE(result_opt.has_value());
+    }
+}
+
+TEST_CASE("Composite Hedged", "[composite]")
+{
+    std::atomic<int> started{0};
+    auto make_tasks = [&started](std::chrono::milliseconds primary, bool primaryThrows)
+    {
+        std::vector<hyp::Task<double(int)>> tasks;
+        tasks.emplace_back(
+            [primary, primaryThrows](int x)
+            {
+                std::this_thread::sleep_for(primary);
+                if (primaryThrows)
+                {
+                    throw std::runtime_error("primary");
+                }
+                return x * 1.0;
+            });
+        for (int i = 2; i <= 3; ++i)
+        {
+            tasks.emplace_back(
+                [&started, i](int x)
+                {
+                    ++started;
+                    return x * static_cast<double>(i);
+                });
+        }
+        return tasks;
+    };
+
+    SECTION("Fast primary starts no backup")
+    {
+        auto [index, result_opt] = hyp::Hedged(make_tasks(0ms, false), 50ms, 1s, 10).get();
+        REQUIRE(index == 0);
+        REQUIRE(result_opt.value() == Catch::Approx(10.0));
+        std::this_thread::sleep_for(60ms);
+        REQUIRE(started == 0);
+    }
+
+    SECTION("Slow primary is hedged after the delay")
+    {
+        auto start = std::chrono::steady_clock::now();
+        auto [index, result_opt] = hyp::Hedged(make_tasks(200ms, false), 10ms, 1s, 10).get();
+        REQUIRE(std::chrono::steady_clock::now() - start < 150ms);
+        REQUIRE(index == 1);
+        REQUIRE(result_opt.value() == Catch::Approx(20.0));
+        REQUIRE(started == 1);
+    }
+
+    SECTION("Failure starts the next function at once")
+    {
+        auto start = std::chrono::steady_clock::now();
+        auto [index, result_opt] = hyp::Hedged(make_tasks(0ms, true), 10s, hyp::Deadline(), 10).get();
+        REQUIRE(std::chrono::steady_clock::now() - start < 1s);
+        REQUIRE(index == 1);
+    }
+
+    SECTION("Deadline")
+    {
+        std::vector<hyp::Task<double(int)>> tasks;
+        tasks.emplace_back(slow_task);
+        auto [index, result_opt] = hyp::Hedged(tasks, 1ms, 20ms, 10).get();
+        REQUIRE(index == -1);
+        REQUIRE_FALSE(result_opt.has_value());
+        REQUIRE(hyp::Hedged(std::vector<hyp::Task<double(int)>>(), 1ms, 20ms, 10).get().first == -1);
+    }
+
+    SECTION("Worker with a quantile delay")
+    {
+        hyp::Worker<double, int> worker;
+        worker.add_function("primary", [](int x) { return x * 1.0; });
+        worker.add_function("backup", [](int x) { return x * 2.0; });
+        worker.enable_stats();
+        for (int i = 0; i < 20; ++i)
+        {
+            REQUIRE(worker.execute_hedged(hyp::HedgeDelay::quantile(0.95, 100ms), i)->first == "primary");
+        }
+        REQUIRE(worker.stats()[0].wins == 20);
+        REQUIRE(worker.stats()[1].completed == 0);
+        REQUIRE(worker.execute_hedged(5ms, 4)->second == Catch::Approx(4.0));
+        REQUIRE_FALSE(hyp::Worker<double, int>().execute_hedged(5ms, 4).has_value());
+    }
+}
+
+TEST_CASE("Composite Quorum", "[composite]")
+{
+    std::vector<hyp::Task<double(int)>> tasks;
+    for (int i = 0; i < 7; ++i)
+    {
+        tasks.emplace_back(
+            [i](int x)
+            {
+                if (i == 1)
+                {
+                    throw std::runtime_error("estimator");
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(i == 6 ? 500 : 5 * i));
+                return static_cast<double>(x + i);
+            });
+    }
+
+    SECTION("Returns once k results arrived")
+    {
+        auto start = std::chrono::steady_clock::now();
+        auto results = hyp::Quorum(3, tasks, 1s, 10).get();
+        REQUIRE(std::chrono::steady_clock::now() - start < 400ms);
+        REQUIRE(results.size() == 3);
+        for (const auto& [index, value] : results)
+        {
+            REQUIRE(index != 1);
+            REQUIRE(index != 6);
+            REQUIRE(value == Catch::Approx(10.0 + index));
+        }
+    }
+
+    SECTION("Predicate and missed quorum")
+    {
+        auto odd = hyp::QuorumWith(2, [](double x) { return static_cast<int>(x) % 2 == 1; }, tasks, 1s, 10).get();
+        REQUIRE(odd.size() == 2);
+        REQUIRE(static_cast<int>(odd[0].second) % 2 == 1);
+
+        auto missed = hyp::Quorum(7, tasks, 100ms, 10).get();
+        REQUIRE(missed.size() == 5);
+        REQUIRE(hyp::Quorum(0, tasks, 1s, 10).get().empty());
+    }
+
+    SECTION("Worker")
+    {
+        hyp::Worker<double, int> worker;
+        worker.add_function("square", fast_task);
+        worker.add_function("fails", [](int) -> double { throw std::runtime_error("fails"); });
+        worker.add_function("identity", [](int x) { return static_cast<double>(x); });
+        worker.add_function("slow", slow_task);
+
+        auto start = std::chrono::steady_clock::now();
+        auto votes = worker.execute_quorum(2, 3);
+        REQUIRE(std::chrono::steady_clock::now() - start < 150ms);
+        REQUIRE(votes.size() == 2);
+        std::set<std::string> names;
+        for (const auto& vote : votes)
+        {
+            names.insert(vote.first);
+        }
+        REQUIRE(names == std::set<std::string>{"square", "identity"});
+
+        auto large = worker.execute_quorum_with(1, [](double x) { return x > 5; }, 3);
+        REQUIRE(large.size() == 1);
+        REQUIRE(large[0].first == "square");
+        REQUIRE(worker.execute_quorum(3, 3, 20ms).size() == 2);
+    }
+}
+
+TEST_CASE("Composite Reduce", "[composite]")
+{
+    std::vector<hyp::Task<long(int)>> tasks;
+    for (long i = 1; i <= 100; ++i)
+    {
+        tasks.emplace_back([i](int x) { return i * x; });
+    }
+    const auto sum = [](long a, long b) { return a + b; };
+
+    REQUIRE(hyp::Reduce(1L, sum, tasks, 1s, 2).get() == 1 + 2 * 5050);
+    REQUIRE(hyp::Reduce(0L, [](long a, long b) { return std::max(a, b); }, tasks, 1s, 3).get() == 300);
+    REQUIRE(hyp::Reduce(7L, sum, std::vector<hyp::Task<long(int)>>(), 1s, 3).get() == 7);
+
+    tasks.emplace_back([](int) -> long { throw std::runtime_error("fails"); });
+    REQUIRE_FALSE(hyp::Reduce(0L, sum, tasks, 1s, 2).get().has_value());
+
+    hyp::Worker<double, int> worker;
+    worker.add_function("square", fast_task);
+    worker.add_function("identity", [](int x) { return static_cast<double>(x); });
+    REQUIRE(worker.execute_reduce(0.0, std::plus<double>(), 3).value() == Catch::Approx(12.0));
+    worker.add_function("slow", slow_task);
+    REQUIRE_FALSE(worker.execute_reduce(0.0, std::plus<double>(), 3, 30ms).has_value());
+}
+
+TEST_CASE("Composite TopK", "[composite]")
+{
+    // Costs 7, 3, 9, 1, 5, 3, ... with one failing task and a slow one
+    std::vector<hyp::Task<int(int)>> tasks;
+    for (int cost : {7, 3, 9, 1, 5, 3})
+    {
+        tasks.emplace_back([cost](int x) { return cost + x; });
+    }
+    tasks.emplace_back([](int) -> int { throw std::runtime_error("fails"); });
+    const auto cheaper = [](int a, int b) { return a < b; };
+
+    SECTION("Best k, sorted with ties in order")
+    {
+        auto top = hyp::TopK(3, cheaper, tasks, 1s, 0).get();
+        REQUIRE(top.size() == 3);
+        REQUIRE(top[0] == std::make_pair(3, 1));
+        REQUIRE(top[1] == std::make_pair(1, 3));
+        REQUIRE(top[2] == std::make_pair(5, 3));
+
+        REQUIRE(hyp::TopK(10, cheaper, tasks, 1s, 0).get().size() == 6);
+        REQUIRE(hyp::TopK(0, cheaper, tasks, 1s, 0).get().empty());
+    }
+
+    SECTION("Bound stops the pending tasks")
+    {
+        auto bounded = tasks;
+        for (int i = 0; i < 3; ++i)
+        {
+            bounded.emplace_back(
+                [](int x)
+                {
+                    std::this_thread::sleep_for(200ms);
+                    return x + 1;
+                });
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        auto top = hyp::TopKBounded(1, cheaper, 1, bounded, 1s, 0).get();
+        REQUIRE(std::chrono::steady_clock::now() - start < 150ms);
+        REQUIRE(top.size() == 1);
+        REQUIRE(top[0].second == 1);
+
+        auto unbounded = hyp::TopK(1, cheaper, bounded, 50ms, 0).get();
+        REQUIRE(unbounded.size() == 1);
+    }
+
+    SECTION("A tie at the bound waits for the tasks before it")
+    {
+        // The later task reaches the bound first, but the earlier one ties it and ranks ahead
+        std::vector<hyp::Task<int(int)>> tied;
+        tied.emplace_back(
+            [](int x)
+            {
+                std::this_thread::sleep_for(50ms);
+                return x + 1;
+            });
+        tied.emplace_back([](int x) { return x + 1; });
+
+        auto top = hyp::TopKBounded(1, cheaper, 1, tied, 1s, 0).get();
+        REQUIRE(top.size() == 1);
+        REQUIRE(top[0] == std::make_pair(0, 1));
+    }
+
+    SECTION("Worker")
+    {
+        hyp::Worker<double, int> worker;
+        worker.add_function("square", fast_task);
+        worker.add_function("identity", [](int x) { return static_cast<double>(x); });
+        worker.add_function("negate", [](int x) { return -static_cast<double>(x); });
+        worker.add_function("fails", [](int) -> double { throw std::runtime_error("fails"); });
+
+        auto top = worker.execute_top_k(2, [](double a, double b) { return a > b; }, 3);
+        REQUIRE(top.size() == 2);
+        REQUIRE(top[0].first == "square");
+        REQUIRE(top[1].first == "identity");
+        worker.enable_stats();
+        auto bounded = worker.execute_top_k_bounded(1, [](double a, double b) { return a < b; }, -3.0, 3);
+        REQUIRE(bounded[0].first == "negate");
+        REQUIRE(worker.stats()[2].wins == 1);
+    }
+}
+
+TEST_CASE("Composite OrderWith", "[composite]")
+{
+    SECTION("OrderWith composite task")
+    {
+        std::vector<hyp::Task<double(int)>> tasks;
+        tasks.emplace_back(
+            [](int x)
+            {
+                std::this_thread::sleep_for(50ms);
+                return x * 1.0; // 10.0
+            });
+        tasks.emplace_back(
+            [](int x)
+            {
+                std::this_thread::sleep_for(10ms);
+                return x * 2.0; // 20.0
+            });
+        tasks.emplace_back(
+            [](int x)
+            {
+                std::this_thread::sleep_for(30ms);
+                return x * 3.0; // 30.0
+            });
+
+        auto composite = hyp::OrderWith([](double val) { return val > 25; }, tasks, 300ms, 10);
+        auto [index, result_opt] = composite.get();
+
+        REQUIRE(index == 2);
+        REQUIRE(result_opt.value() == Catch::Approx(30.0));
+    }
+
+    SECTION("OrderWith timeout")
+    {
+        std::vector<hyp::Task<double(int)>> tasks;
+        tasks.emplace_back(
+            [](int x)
+            {
+                std::this_thread::sleep_for(100ms);
+                return x * 1.0;
+            });
+        tasks.emplace_back(
+            [](int x)
+            {
+                std::this_thread::sleep_for(200ms);
+                return x * 2.0;
+            });
+
+        auto composite = hyp::OrderWith([](double) { return true; }, tasks, 50ms, 10);
+        auto [index, result_opt] = composite.get();
+
+        REQUIRE(index == -1);
+        REQUIRE_FALSE(result_opt.has_value());
+    }
+}
+
+TEST_CASE("Task combinations", "[combo]")
+{
+    SECTION("All + then")
+    {
+        std::vector<hyp::Task<double(int)>> tasks;
+        tasks.emplace_back([](int x) { return x * 1.0; });
+        tasks.emplace_back([](int x) { return x * 2.0; });
+
+        auto all_task = hyp::All(tasks, 0ms, 5);
+        auto sum_task = all_task.then(
+            [](std::optional<std::vector<double>> results_opt)
+            {
+                REQUIRE(results_opt.has_value());
+                auto& results = *results_opt;
+                return std::accumulate(results.begin(), results.end(), 0.0);
+            });
+
+        REQUIRE(sum_task.get() == Catch::Approx(15.0));
+    }
+
+    SECTION("Any + then")
+    {
+        std::vector<hyp::Task<double(int)>> tasks;
+        tasks.emplace_back(
+            [](int x)
+            {
+                std::this_thread::sleep_for(50ms);
+                return x * 1.0;
+            });
+        tasks.emplace_back([](int x) { return x * 2.0; });
+
+        auto any_task = hyp::Any(tasks, 0ms, 5);
+        auto process_task = any_task.then(
+            [](auto pair)
+            {
+                REQUIRE(pair.first >= 0);
+                return pair.second.value() * 10;
+            });
+
+        REQUIRE(process_task.get() == Catch::Approx(100.0));
+    }
+}
+
+TEST_CASE("Worker boundary cases", "[Worker]")
+{
+    hyp::Worker<double, int> worker;
+
+    SECTION("Single task Any")
+    {
+        worker.add_function("single", [](int x) { return x * 1.0; });
+        auto result = worker.execute_any(5);
+        REQUIRE(result.has_value());
+        REQUIRE(result.value().second == Catch::Approx(5.0));
+    }
+
+    SECTION("Single task All")
+    {
+        worker.add_function("single", [](int x) { return x * 1.0; });
+        auto results = worker.execute_all(5);
+        REQUIRE(results.size() == 1);
+        REQUIRE(results[0].second == Catch::Approx(5.0));
+    }
+
+    SECTION("Single task AnyWith")
+    {
+        worker.add_function("single", [](int x) { return x * 1.0; });
+        auto result = worker.execute_any_with([](double v) { return v > 0; }, 5);
+        REQUIRE(result.has_value());
+        REQUIRE(result.value().second == Catch::Approx(5.0));
+    }
+
+    SECTION("Single task OrderWith")
+    {
+        worker.add_function("single",
+                            [](int x)
+                            {
+                                std::this_thread::sleep_for(10ms);
+                                return x * 1.0;
+                            });
+        auto result = worker.execute_order_with([](double v) { return v > 0; }, 5);
+        REQUIRE(result.has_value());
+        REQUIRE(result.value().second == Catch::Approx(5.0));
+    }
+}
+
+TEST_CASE("Deadlines", "[timeout]")
+{
+    hyp::Worker<double, int> worker;
+    worker.add_function("slow", slow_task);
+
+    SECTION("Sub-millisecond budget")
+    {
+        auto start = std::chrono::steady_clock::now();
+        REQUIRE_FALSE(worker.execute_any(2, 500us).has_value());
+        REQUIRE(std::chrono::steady_clock::now() - start < 100ms);
+    }
+
+    SECTION("Zero budget is not the same as no deadline")
+    {
+        auto start = std::chrono::steady_clock::now();
+        REQUIRE(worker.execute_all(2, hyp::Deadline::within(0ns)).empty());
+        REQUIRE(std::chrono::steady_clock::now() - start < 100ms);
+
+        REQUIRE(worker.execute_all(2, hyp::Deadline::none()).size() == 1);
+        REQUIRE(worker.execute_all(2, 0ns).size() == 1);
+    }
+
+    SECTION("Absolute deadline")
+    {
+        auto start = std::chrono::steady_clock::now();
+        REQUIRE_FALSE(worker.execute_order_with([](double) { return true; }, 2, start + 20ms).has_value());
+        REQUIRE(std::chrono::steady_clock::now() - start < 150ms);
+
+        std::vector<hyp::Task<double(int)>> tasks;
+        tasks.emplace_back(fast_task);
+        auto [index, result] = hyp::Any(tasks, std::chrono::steady_clock::now() + 1s, 3).get();
+        REQUIRE(index == 0);
+        REQUIRE(result == Catch::Approx(9.0));
+    }
+
+    SECTION("Deadline helpers")
+    {
+        REQUIRE_FALSE(hyp::Deadline().is_set());
+        REQUIRE_FALSE(hyp::Deadline(0ms).is_set());
+        REQUIRE(hyp::Deadline(1us).is_set());
+        REQUIRE(hyp::Deadline::within(0ns).expired());
+        REQUIRE_FALSE(hyp::Deadline(std::chrono::hours::max()).start().is_set());
+        REQUIRE(hyp::Deadline(std::chrono::steady_clock::now() - 1ms).expired());
+    }
+}
+
+TEST_CASE("Extreme timeouts", "[timeout]")
+{
+    hyp::Worker<double, int> worker;
+    worker.add_function("fast", [](int x) { return x * 1.0; });
+    worker.add_function("slow",
+                        [](int x)
+                        {
+                            std::this_thread::sleep_for(100ms);
+                            return x * 2.0;
+                        });
+
+    SECTION("Zero timeout")
+    {
+        auto start = std::chrono::steady_clock::now();
+        auto results = worker.execute_all(5, 0ms);
+        auto duration = std::chrono::steady_clock::now() - start;
+
+        REQUIRE(duration >= 100ms);
+        REQUIRE(results.size() == 2);
+    }
+
+    SECTION("Large timeout")
+    {
+        auto start = std::chrono::steady_clock::now();
+        auto results = worker.execute_all(5, 500ms);
+        auto duration = std::chrono::steady_clock::now() - start;
+
+        REQUIRE(duration < 500ms);
+        REQUIRE(results.size() == 2);
+    }
+
+    SECTION("Exact timeout")
+    {
+        worker.add_function("exact",
+                            [](int x)
+                            {
+                                std::this_thread::sleep_for(50ms);
+                                return x * 3.0;
+                            });
+
+        auto start = std::chrono::steady_clock::now();
+        auto results = worker.execute_all(5, 50ms);
+        auto duration = std::chrono::steady_clock::now() - start;
+
+        REQUIRE(duration >= 50ms);
+        REQUIRE(results.size() == 0);
+    }
+}
+
+TEST_CASE("Combination strategies", "[combo]")
+{
+    hyp::Worker<double, int> worker;
+    worker.add_function("task1", [](int x) { return x * 1.0; });
+    worker.add_function("task2", [](int x) { return x * 2.0; });
+    worker.add_function("task3", [](int x) { return x * 3.0; });
+
+    SECTION("Any + Best")
+    {
+        auto any_result = worker.execute_any(5);
+        REQUIRE(any_result.has_value());
+
+        auto best_result = worker.execute_best([](double a, double b) { return a < b; }, 5);
+        REQUIRE(best_result.has_value());
+        REQUIRE(best_result.value().second == Catch::Approx(5.0));
+    }
+
+    SECTION("OrderWith + then")
+    {
+        auto order_result = worker.execute_order_with([](double v) { return v > 10; }, 5);
+        REQUIRE(order_result.has_value());
+
+        hyp::Task<double()> task([res = order_result.value().second]() -> double { return res * 2; });
+        REQUIRE(task.get() == Catch::Approx(30.0));
+    }
+}
+
+TEST_CASE("OrderWith boundary cases", "[Worker]")
+{
+    hyp::Worker<double, int> worker;
+
+    SECTION("No tasks")
+    {
+        auto result = worker.execute_order_with([](double) { return true; }, 5);
+        REQUIRE_FALSE(result.has_value());
+    }
+
+    SECTION("Single task immediate")
+    {
+        worker.add_function("task1", [](int x) { return x * 1.0; });
+        auto result = worker.execute_order_with([](double v) { return v > 0; }, 5);
+        REQUIRE(result.has_value());
+        REQUIRE(result->first == "task1");
+        REQUIRE(result->second == 5.0);
+    }
+
+    SECTION("Single task delayed")
+    {
+        worker.add_function("task1",
+                            [](int x)
+                            {
+                                std::this_thread::sleep_for(10ms);
+                                return x * 1.0;
+                            });
+        auto result = worker.execute_order_with([](double v) { return v > 0; }, 5);
+        REQUIRE(result.has_value());
+        REQUIRE(result->first == "task1");
+        REQUIRE(result->second == 5.0);
+    }
+
+    SECTION("Order of execution respected")
+    {
+        worker.add_function("task1",
+                            [](int x)
+                            {
+                                std::this_thread::sleep_for(30ms);
+                                return x * 1.0; // 5.0
+                            });
+        worker.add_function("task2",
+                            [](int x)
+                            {
+                                std::this_thread::sleep_for(10ms);
+                                return x * 2.0; // 10.0
+                            });
+        worker.add_function("task3",
+                            [](int x)
+                            {
+                                std::this_thread::sleep_for(20ms);
+                                return x * 3.0; // 15.0
+                            });
+
+        // Should find task2 first even though it completes earliest
+        auto result = worker.execute_order_with([](double v) { return v > 8; }, 5);
+
+        REQUIRE(result.has_value());
+        REQUIRE(result->first == "task2");
+        REQUIRE(result->second == 10.0);
+    }
+}
+
+TEST_CASE("All/Best timeout handling", "[timeout]")
+{
+    hyp::Worker<double, int> worker;
+
+    worker.add_function("fast",
+                        [](int x)
+                        {
+                            std::this_thread::sleep_for(10ms);
+                            return x * 1.0;
+                        });
+    worker.add_function("slow",
+                        [](int x)
+                        {
+                            std::this_thread::sleep_for(100ms);
+                            return x * 2.0;
+                        });
+
+    SECTION("All timeout")
+    {
+        auto results = worker.execute_all(5, 50ms);
+        REQUIRE(results.size() == 0);
+    }
+
+    SECTION("Best timeout")
+    {
+        auto result = worker.execute_best([](double a, double b) { return a < b; }, 5, 50ms);
+
+        REQUIRE_FALSE(result.has_value());
+    }
+}
+
+#ifdef HYPARA_COROUTINES
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wzero-as-null-pointer-constant" // GCC 12 trips it on its own coroutine frames
+#endif
+
+inline hyp::Co<double> coroutine_chain(hyp::Task<double(int)> square, int x)
+{
+    // Each co_await suspends instead of blocking a thread while the task runs
+    double first = co_await hyp::awaitable(square, x);
+    double second = co_await hyp::awaitable(square, static_cast<int>(first));
+    co_return first + second;
+}
+
+inline hyp::Co<size_t> coroutine_all(std::vector<hyp::Task<double(int)>> tasks)
+{
+    auto results = co_await hyp::All(tasks, 1s, 3);
+    co_return results ? results->size() : 0;
+}
+
+inline hyp::Co<int> coroutine_move_only(hyp::Task<int(std::unique_ptr<int>)> by_value,
+                                        hyp::Task<int(const std::unique_ptr<int>&)> by_reference)
+{
+    int first = co_await hyp::awaitable(by_value, std::make_unique<int>(2));
+    int second = co_await hyp::awaitable(by_reference, std::make_unique<int>(3));
+    co_return first + second;
+}
+
+inline hyp::Co<void> coroutine_throws(hyp::Task<double(int)> task)
+{
+    co_await hyp::awaitable(task, 1);
+}
+
+inline hyp::Co<std::thread::id> coroutine_combinators(std::vector<hyp::Task<double(int)>> tasks)
+{
+    // The combinators resume from their slots, so inline tasks keep the coroutine on its thread
+    auto all = co_await hyp::All(tasks, 1s, 2);
+    auto any = co_await hyp::Any(tasks, 1s, 2);
+    auto any_with = co_await hyp::AnyWith([](double value) { return value > 1.0; }, tasks, 1s, 2);
+    auto none = co_await hyp::All(std::vector<hyp::Task<double(int)>>(), 1s, 2);
+    if (!all || all->size() != tasks.size() || any.first != 0 || any_with.first != 0 || !none || !none->empty())
+    {
+        co_return std::thread::id();
+    }
+    co_return std::this_thread::get_id();
+}
+
+inline hyp::Co<bool> coroutine_deadline(std::vector<hyp::Task<double(int)>> tasks)
+{
+    auto all = co_await hyp::All(tasks, 20ms, 1);
+    auto any = co_await hyp::Any(tasks, 20ms, 1);
+    co_return !all && any.first == -1;
+}
+
+TEST_CASE("Coroutines", "[coroutine]")
+{
+    hyp::Task<double(int)> square(fast_task);
+    REQUIRE(coroutine_chain(square, 3).get() == Catch::Approx(90.0));
+
+    std::vector<hyp::Task<double(int)>> tasks(3, square);
+    REQUIRE(coroutine_all(tasks).get() == 3);
+
+    auto nested = [](hyp::Task<double(int)> task) -> hyp::Co<double>
+    { co_return co_await coroutine_chain(task, 2) + 1; };
+    REQUIRE(nested(square).get() == Catch::Approx(21.0));
+
+    hyp::Task<int(std::unique_ptr<int>)> consume([](std::unique_ptr<int> value) { return *value; });
+    hyp::Task<int(const std::unique_ptr<int>&)> read([](const std::unique_ptr<int>& value) { return *value; });
+    REQUIRE(coroutine_move_only(consume, read).get() == 5);
+
+    hyp::Task<double(int)> failing([](int) -> double { throw std::runtime_error("fails"); });
+    REQUIRE_THROWS_AS(coroutine_throws(failing).get(), std::runtime_error);
+
+    SECTION("Awaited combinators do not occupy a thread")
+    {
+        std::vector<hyp::Task<double(int)>> inline_tasks(3, square.inlined());
+        REQUIRE(coroutine_combinators(inline_tasks).get() == std::this_thread::get_id());
+    }
+
+    SECTION("Awaited combinators resume at their deadline")
+    {
+        hyp::ThreadPool pool(2);
+        // Stopped at the deadline, which frees the pool for the resume
+        hyp::Task<double(int)> slow(
+            [](const hyp::StopToken& token, int x)
+            {
+                const auto until = std::chrono::steady_clock::now() + 200ms;
+                while (!token.stop_requested() && std::chrono::steady_clock::now() < until)
+                {
+                    std::this_thread::sleep_for(1ms);
+                }
+                return static_cast<double>(x);
+            },
+            pool);
+        const auto start = std::chrono::steady_clock::now();
+        REQUIRE(coroutine_deadline({slow, slow}).get());
+        REQUIRE(std::chrono::steady_clock::now() - start < 190ms);
+    }
+
+    SECTION("Waiting for a coroutine helps the pool")
+    {
+        hyp::ThreadPool single(1);
+        hyp::Task<double(int)> on_single(fast_task, single);
+        hyp::Task<double()> outer([&on_single]() { return coroutine_chain(on_single, 3).get(); }, single);
+        REQUIRE(outer.run().get() == Catch::Approx(90.0));
+    }
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif